@@ -11,15 +11,105 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <cstdint>
 
 #include "utils/io.hpp"
 #include "utils/geometry.hpp"
 #include "utils/scale.hpp"
+#include "ground/ground.hpp"
+
+/**
+ * @brief 按格子编号的A*工作区，用版本戳代替每次查询前的清零
+ */
+struct SearchSpace {
+    std::vector<double> cost;
+    std::vector<int> parent;
+    std::vector<uint32_t> seen;
+    std::vector<uint32_t> closed;
+    uint32_t epoch = 0;
+
+    /**
+     * @brief 准备一次新的查询，版本戳溢出时才真正清零
+     */
+    void prepare(size_t cells);
+};
+
+/**
+ * @brief 网格A*的公共核心，各种A*变体只提供启发式、通行条件和终点判断
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标，调用者保证可通行
+ * @param heuristic 到终点的可采纳下界
+ * @param allowed 通行条件，为空时使用graph.edge_allowed
+ * @param is_goal 按格子编号 x * cols + y 判断是否为终点
+ * @param space 工作区
+ * @return 从起点到第一个出队的终点的路径，找不到终点时返回空序列
+ */
+std::vector<Intex> grid_star(const SqPlain& graph, const Intex& start,
+                             const std::function<double(const Intex&)>& heuristic,
+                             const std::function<bool(const Intex&)>& allowed,
+                             const std::function<bool(int)>& is_goal,
+                             SearchSpace& space);
+
+/**
+ * @brief 使用线程局部工作区的grid_star
+ */
+std::vector<Intex> grid_star(const SqPlain& graph, const Intex& start,
+                             const std::function<double(const Intex&)>& heuristic,
+                             const std::function<bool(const Intex&)>& allowed,
+                             const std::function<bool(int)>& is_goal);
 
 std::vector<Intex> a_star_search(const SqPlain& graph, const Intex& start, const Intex& goal);
 
+/**
+ * @brief 在地面上搜索路径，先用连通分量排除不可达的终点
+ * 
+ * @param ground 地面对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> a_star_search(const Ground& ground, const Intex& start, const Intex& goal);
+
+/**
+ * @brief 在地面上搜索与障碍保持距离的路径
+ * 
+ * @param ground 地面对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param margin 路径上每个格子到最近障碍的最小距离
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> a_star_search(const Ground& ground, const Intex& start, const Intex& goal, double margin);
+
+/**
+ * @brief 搜索到一组终点中代价最小者的路径
+ * 
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goals 候选终点
+ * @return 到最先确定的终点的路径，path.back()即该终点，全部不可达时返回空序列
+ */
+std::vector<Intex> nearest_star(const SqPlain& graph, const Intex& start, const std::vector<Intex>& goals);
+
+/**
+ * @brief 在地面上搜索最近终点，先剔除与起点不在同一连通分量的终点
+ */
+std::vector<Intex> nearest_star(const Ground& ground, const Intex& start, const std::vector<Intex>& goals);
+
+/**
+ * @brief 单源最短路径，返回到所有格子的代价
+ * 
+ * @param graph 二维地图对象
+ * @param source 源点坐标
+ * @return 按 x * cols + y 排列的代价表，不可达格子为无穷大
+ */
+std::vector<double> dijkstra(const SqPlain& graph, const Intex& source);
+
 std::vector<Intex> scale_star(const SqPlain& graph, const Intex& start, const Intex& goal, const double& scale);
 
+std::vector<Intex> scale_star(const Ground& ground, const Intex& start, const Intex& goal, const double& scale);
+
 // std::vector<SqDot> scale_star(const SqPlain& graph, const SqDot& start, const SqDot& goal, const double& scale);
 
 // 地面采集算法，待完成
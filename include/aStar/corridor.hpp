@@ -0,0 +1,116 @@
+#ifndef CORRIDOR_HPP
+#define CORRIDOR_HPP
+
+class Corridor;
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <atomic>
+
+#include "aStar/aStar.hpp"
+#include "ground/ground.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 引导折线周围的搜索走廊
+ * 按行保存互不相交的列区间，走廊内的格子按行、列顺序编号为紧凑的局部下标
+ */
+class Corridor {
+public:
+    Corridor();
+
+    /**
+     * @brief 构造函数，以引导折线为中心线生成走廊
+     *
+     * @param graph 二维地图对象
+     * @param guides 引导点序列
+     * @param radius 走廊半宽（切比雪夫距离）
+     */
+    Corridor(const SqPlain& graph, const std::vector<Intex>& guides, int radius);
+
+    /**
+     * @brief 格子的局部下标
+     *
+     * @param at 格子坐标
+     * @return 局部下标，不在走廊内时返回-1
+     */
+    int index(const Intex& at) const;
+
+    /**
+     * @brief 局部下标对应的格子坐标
+     */
+    Intex cell(int index) const;
+
+    bool contains(const Intex& at) const;
+
+    /**
+     * @brief 走廊内的格子数
+     */
+    int size() const;
+
+    bool empty() const;
+
+private:
+    struct Span {
+        int y0;
+        int y1;
+        int offset;
+    };
+
+    int first_row;
+
+    /**
+     * @brief 第 first_row + i 行的区间为 spans[row_start[i], row_start[i + 1])
+     */
+    std::vector<int> row_start;
+    std::vector<Span> spans;
+    int total;
+};
+
+/**
+ * @brief 只在走廊内搜索的A*
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param corridor 搜索走廊
+ * @return 从起点到终点的路径点序列，走廊内不连通时返回空序列
+ */
+std::vector<Intex> corridor_star(const SqPlain& graph, const Intex& start, const Intex& goal, const Corridor& corridor);
+
+/**
+ * @brief 先用scale_star求粗略引导点，再在引导折线周围的走廊内细化为全分辨率路径
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param scale 缩放比例
+ * @param radius 走廊半宽
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> refine_star(const SqPlain& graph, const Intex& start, const Intex& goal, const double& scale, int radius);
+
+std::vector<Intex> refine_star(const Ground& ground, const Intex& start, const Intex& goal, const double& scale, int radius);
+
+/**
+ * @brief 分段并行细化：相邻引导点之间各自在局部走廊内搜索，再按顺序拼接
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param scale 缩放比例
+ * @param radius 每段走廊的半宽
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> segment_star(const SqPlain& graph, const Intex& start, const Intex& goal, const double& scale, int radius, int threads=0);
+
+std::vector<Intex> segment_star(const Ground& ground, const Intex& start, const Intex& goal, const double& scale, int radius, int threads=0);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef DELTA_HPP
+#define DELTA_HPP
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 并行delta-stepping单源最短路径
+ *
+ * 代价定义与dijkstra相同，格子按行条带划分给各线程，每个线程只写自己负责的格子，
+ * 其他线程的松弛请求经由收件箱转交，同一个桶内的请求处理完毕后再推进到下一个桶
+ *
+ * @param graph 二维地图对象
+ * @param source 源点坐标
+ * @param delta 桶宽度，不大于0时取最小单步代价（此时每个桶只需一轮，与Dijkstra等价）
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ * @return 按 x * cols + y 排列的代价表，不可达格子为无穷大
+ */
+std::vector<double> delta_stepping(const SqPlain& graph, const Intex& source, double delta=0.0, int threads=0);
+
+#endif
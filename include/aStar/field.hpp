@@ -0,0 +1,183 @@
+#ifndef FIELD_HPP
+#define FIELD_HPP
+
+class CostField;
+class FieldCache;
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <limits>
+#include <cstdint>
+
+#include "aStar/aStar.hpp"
+#include "aStar/delta.hpp"
+#include "ground/ground.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+
+/**
+ * @brief 以终点为根的代价场
+ * 保存地图上每个格子到终点的最短代价，可直接沿梯度下降得到路径，
+ * 也可作为同一终点的细粒度搜索的精确启发式
+ */
+class CostField {
+public:
+    /**
+     * @brief 终点坐标
+     */
+    Intex goal;
+
+    CostField();
+
+    /**
+     * @brief 构造函数，计算全图到终点的代价
+     *
+     * @param graph 二维地图对象
+     * @param goal 终点坐标
+     */
+    CostField(const SqPlain& graph, const Intex& goal);
+
+    /**
+     * @brief 查询格子到终点的最短代价
+     *
+     * @param at 格子坐标
+     * @return 最短代价，越界或不可达时为无穷大
+     */
+    double cost(const Intex& at) const;
+
+    /**
+     * @brief 精确启发式，与cost相同
+     */
+    double heuristic(const Intex& at) const;
+
+    /**
+     * @brief 沿代价场下降得到从start到终点的路径
+     *
+     * @param graph 构建代价场时使用的地图
+     * @param start 起点坐标
+     * @return 路径点序列，不可达时返回空序列
+     */
+    std::vector<Intex> descend(const SqPlain& graph, const Intex& start) const;
+
+    /**
+     * @brief 代价场占用的内存字节数
+     */
+    size_t bytes() const;
+
+    bool empty() const;
+
+private:
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 按 x * cols + y 排列的到终点代价
+     */
+    std::vector<double> togo;
+};
+
+/**
+ * @brief 代价场缓存
+ * 按（地图，终点，地图版本）索引，超过内存预算时淘汰最久未使用的代价场，可在多线程间共享；
+ * 地图由其地址、形状以及所属地面的编号区分，同一缓存可以服务多张地图
+ */
+class FieldCache {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param budget 内存预算（字节）
+     */
+    explicit FieldCache(size_t budget=256u << 20);
+
+    /**
+     * @brief 获取代价场，不存在时计算并缓存
+     *
+     * @param graph 二维地图对象
+     * @param goal 终点坐标
+     * @param version 地图版本，地图修改后应递增
+     * @return 代价场
+     */
+    std::shared_ptr<const CostField> get(const SqPlain& graph, const Intex& goal, uint64_t version);
+
+    /**
+     * @brief 获取地面当前版本的代价场，按地面编号区分不同的地面
+     *
+     * @param ground 地面对象
+     * @param goal 终点坐标
+     * @return 代价场
+     */
+    std::shared_ptr<const CostField> get(const Ground& ground, const Intex& goal);
+
+    /**
+     * @brief 使用缓存的代价场求路径
+     *
+     * @param graph 二维地图对象
+     * @param start 起点坐标
+     * @param goal 终点坐标
+     * @param version 地图版本
+     * @return 路径点序列，不可达时返回空序列
+     */
+    std::vector<Intex> path(const SqPlain& graph, const Intex& start, const Intex& goal, uint64_t version);
+
+    /**
+     * @brief 使用地面当前版本的代价场求路径
+     */
+    std::vector<Intex> path(const Ground& ground, const Intex& start, const Intex& goal);
+
+    /**
+     * @brief 缓存中的代价场数量
+     */
+    size_t size() const;
+
+    /**
+     * @brief 缓存占用的内存字节数
+     */
+    size_t bytes() const;
+
+    void clear();
+
+private:
+    struct Key {
+        /**
+         * @brief 地图地址与形状
+         */
+        const SqPlain* graph;
+        int rows;
+        int cols;
+
+        /**
+         * @brief 所属地面的编号，直接传入SqPlain时为0
+         */
+        uint64_t owner;
+
+        int x;
+        int y;
+        uint64_t version;
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    using Entry = std::pair<Key, std::shared_ptr<const CostField>>;
+
+    size_t budget;
+    size_t used;
+    mutable std::mutex lock;
+
+    /**
+     * @brief 按使用时间排列，表头为最近使用
+     */
+    std::list<Entry> order;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    std::shared_ptr<const CostField> fetch(const SqPlain& graph, const Key& key);
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef HIERARCHY_HPP
+#define HIERARCHY_HPP
+
+struct Arc;
+class Hierarchy;
+
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <string>
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+#include "ground/ground.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/io.hpp"
+
+/**
+ * @brief 收缩层次图中的一条边
+ */
+struct Arc {
+    /**
+     * @brief 目标格子编号
+     */
+    int to;
+
+    /**
+     * @brief 边权
+     */
+    double weight;
+
+    /**
+     * @brief 捷径经过的被收缩格子编号，原始边为-1
+     */
+    int middle;
+};
+
+/**
+ * @brief 收缩层次（Contraction Hierarchies）索引
+ * 针对静态地图的预处理，之后的起终点查询只需在向上图中做双向搜索
+ */
+class Hierarchy {
+public:
+    Hierarchy();
+
+    /**
+     * @brief 构造函数，对地图进行收缩预处理
+     *
+     * @param graph 二维地图对象
+     */
+    explicit Hierarchy(const SqPlain& graph);
+
+    /**
+     * @brief 查询两点间的路径
+     *
+     * @param start 起点坐标
+     * @param goal 终点坐标
+     * @return 展开捷径后的格子路径，不可达时返回空序列
+     */
+    std::vector<Intex> query(const Intex& start, const Intex& goal) const;
+
+    /**
+     * @brief 查询两点间的路径，先用地面的连通分量排除不可达的终点
+     */
+    std::vector<Intex> query(const Ground& ground, const Intex& start, const Intex& goal) const;
+
+    /**
+     * @brief 查询两点间的最短代价（与a_star_search的代价定义一致）
+     *
+     * @param start 起点坐标
+     * @param goal 终点坐标
+     * @return 最短代价，不可达时为无穷大
+     */
+    double distance(const Intex& start, const Intex& goal) const;
+
+    /**
+     * @brief 将索引写入二进制文件
+     *
+     * @param filename 文件路径
+     * @return 写入成功返回true
+     */
+    bool save(const std::string& filename) const;
+
+    /**
+     * @brief 从二进制文件读取索引
+     *
+     * @param filename 文件路径
+     * @return 读取成功返回true
+     */
+    bool load(const std::string& filename);
+
+    bool empty() const;
+
+    int rows() const;
+
+    int cols() const;
+
+private:
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 每个格子的收缩次序，障碍格子为-1
+     */
+    std::vector<int> rank;
+
+    /**
+     * @brief 格子高度，用于把对称边权还原为有向代价
+     */
+    std::vector<double> height;
+
+    /**
+     * @brief 向上图（压缩行存储），只保存指向更高次序格子的边
+     */
+    std::vector<int> up_start;
+    std::vector<Arc> up_arcs;
+
+    bool meet(int source, int target, std::vector<int>& chain, double& best) const;
+
+    void unpack(int from, int to, std::vector<int>& cells) const;
+};
+
+#endif
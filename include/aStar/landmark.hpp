@@ -0,0 +1,109 @@
+#ifndef LANDMARK_HPP
+#define LANDMARK_HPP
+
+class Landmarks;
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "aStar/aStar.hpp"
+#include "aStar/delta.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+
+/**
+ * @brief ALT地标预处理
+ * 为若干地标保存到全图的距离表，利用三角不等式给出可采纳的启发式下界
+ */
+class Landmarks {
+public:
+    /**
+     * @brief 地标坐标
+     */
+    std::vector<Intex> anchors;
+
+    Landmarks();
+
+    /**
+     * @brief 构造函数，选取地标并计算距离表
+     *
+     * @param graph 二维地图对象
+     * @param count 地标数量
+     */
+    Landmarks(const SqPlain& graph, int count=8);
+
+    /**
+     * @brief 构造函数，由地面对象的地图构建，并记下地面编号与版本号
+     *
+     * @param ground 地面对象
+     * @param count 地标数量
+     */
+    Landmarks(const Ground& ground, int count=8);
+
+    /**
+     * @brief 计算从at到goal的代价下界
+     *
+     * @param graph 构建地标时使用的地图
+     * @param at 当前点
+     * @param goal 终点
+     * @return 代价下界
+     */
+    double heuristic(const SqPlain& graph, const Intex& at, const Intex& goal) const;
+
+    /**
+     * @brief 地标是否由ground的当前版本构建，地图修改后旧的距离表不再给出下界
+     */
+    bool fresh(const Ground& ground) const;
+
+    bool empty() const;
+
+    int rows() const;
+
+    int cols() const;
+
+private:
+    /**
+     * @brief 距离表中表示不可达的值
+     */
+    static constexpr uint32_t unreachable = std::numeric_limits<uint32_t>::max();
+
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 构建时地面对象的编号与版本号，由SqPlain构建时编号为0
+     */
+    uint64_t ground_id;
+    uint64_t ground_version;
+
+    /**
+     * @brief 距离截断到整数带来的误差余量
+     */
+    double slack;
+
+    /**
+     * @brief 每个地标到全图的距离（向下取整）
+     */
+    std::vector<std::vector<uint32_t>> tables;
+};
+
+/**
+ * @brief 使用地标启发式的A*搜索
+ *
+ * @param graph 二维地图对象
+ * @param marks 由graph构建的地标
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 从起点到终点的路径点序列，不可达或地标与地图尺寸不符时返回空序列
+ */
+std::vector<Intex> alt_star(const SqPlain& graph, const Landmarks& marks, const Intex& start, const Intex& goal);
+
+/**
+ * @brief 使用地标启发式的A*搜索，地标不是由ground当前版本构建时退回a_star_search
+ */
+std::vector<Intex> alt_star(const Ground& ground, const Landmarks& marks, const Intex& start, const Intex& goal);
+
+#endif
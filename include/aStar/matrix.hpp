@@ -0,0 +1,51 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include <vector>
+#include <queue>
+#include <atomic>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include "ground/ground.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 计算若干路径点之间的两两最短代价
+ *
+ * @param graph 二维地图对象
+ * @param points 路径点序列
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ * @return N×N代价矩阵，matrix[i][j]为从points[i]到points[j]的代价，不可达为无穷大
+ */
+std::vector<std::vector<double>> cost_matrix(const SqPlain& graph, const std::vector<Intex>& points, int threads=0);
+
+/**
+ * @brief 在地面上计算代价矩阵，不同连通分量之间的点对不参与搜索
+ */
+std::vector<std::vector<double>> cost_matrix(const Ground& ground, const std::vector<Intex>& points, int threads=0);
+
+/**
+ * @brief 按访问顺序计算总代价
+ *
+ * @param matrix 代价矩阵
+ * @param order 访问顺序
+ * @param closed 是否回到第一个点
+ */
+double tour_cost(const std::vector<std::vector<double>>& matrix, const std::vector<int>& order, bool closed=false);
+
+/**
+ * @brief 启发式求路径点的访问顺序
+ *
+ * @param matrix 代价矩阵
+ * @param first 第一个访问的点
+ * @param closed 是否回到第一个点
+ * @return 点的下标序列，以first开头
+ */
+std::vector<int> visit_order(const std::vector<std::vector<double>>& matrix, int first=0, bool closed=false);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef PLANNER_HPP
+#define PLANNER_HPP
+
+struct Query;
+class Planner;
+
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+
+#include "aStar/aStar.hpp"
+#include "ground/ground.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 一次路径查询
+ */
+struct Query {
+    Intex start;
+    Intex goal;
+};
+
+/**
+ * @brief 共享只读地面的路径规划入口
+ * 只通过const接口访问地面，多个线程可同时调用；每个线程使用各自的搜索工作区，
+ * 批量查询时由若干工作线程从共享计数器领取查询
+ */
+class Planner {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param ground 地面对象，规划期间不能修改
+     * @param threads 批量查询的线程数，不大于0时使用hardware_threads()
+     */
+    explicit Planner(const Ground& ground, int threads=0);
+
+    /**
+     * @brief 单次查询，代价与a_star_search相同
+     *
+     * @param start 起点坐标
+     * @param goal 终点坐标
+     * @return 从起点到终点的路径点序列，不可达时返回空序列
+     */
+    std::vector<Intex> plan(const Intex& start, const Intex& goal) const;
+
+    /**
+     * @brief 批量查询
+     *
+     * @param queries 查询序列
+     * @return 与queries一一对应的路径，结果与线程数无关
+     */
+    std::vector<std::vector<Intex>> plan(const std::vector<Query>& queries) const;
+
+    int threads() const;
+
+private:
+    const Ground& ground;
+    int worker_count;
+
+    std::vector<Intex> search(const Intex& start, const Intex& goal, SearchSpace& space) const;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef QUADTREE_HPP
+#define QUADTREE_HPP
+
+class QuadLeaf;
+class QuadTree;
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include "ground/ground.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+
+/**
+ * @brief 四叉树叶子节点
+ * 表示地图上一块高度一致的正方形区域 [x, x+size) × [y, y+size)
+ */
+class QuadLeaf {
+public:
+    /**
+     * @brief 区域左上角的行坐标
+     */
+    int x;
+
+    /**
+     * @brief 区域左上角的列坐标
+     */
+    int y;
+
+    /**
+     * @brief 区域边长
+     */
+    int size;
+
+    /**
+     * @brief 区域平均高度
+     */
+    double height;
+
+    /**
+     * @brief 区域是否整体为障碍
+     */
+    bool blocked;
+
+    QuadLeaf(int x, int y, int size, double height, bool blocked);
+
+    /**
+     * @brief 判断点是否位于叶子区域内
+     *
+     * @param point 检查点
+     * @return 如果点在区域内返回true，否则返回false
+     */
+    bool contains(const Intex& point) const;
+
+    /**
+     * @brief 获取叶子区域的中心格子
+     *
+     * @return 中心格子坐标
+     */
+    Intex center() const;
+
+    /**
+     * @brief 将点限制到叶子区域内
+     *
+     * @param point 原始点
+     * @return 区域内距离原始点最近的格子
+     */
+    Intex clamp(const Intex& point) const;
+};
+
+/**
+ * @brief 自适应四叉树地形分解
+ * 将高度一致且无障碍的区域合并为大叶子，复杂区域保持格子分辨率
+ */
+class QuadTree {
+public:
+    /**
+     * @brief 所有叶子节点
+     */
+    std::vector<QuadLeaf> leaves;
+
+    /**
+     * @brief 所有可通行叶子中的最小高度，用于启发式函数
+     */
+    double min_height;
+
+    QuadTree();
+
+    /**
+     * @brief 构造函数，从地图构建四叉树
+     *
+     * @param graph 原始地图
+     * @param tolerance 允许合并的最大高度差
+     * @param max_size 叶子的最大边长（2的幂）
+     */
+    QuadTree(const SqPlain& graph, double tolerance=0.0, int max_size=64);
+
+    /**
+     * @brief 查找格子所属的叶子
+     *
+     * @param point 格子坐标
+     * @return 叶子编号，地图外返回-1
+     */
+    int locate(const Intex& point) const;
+
+    /**
+     * @brief 获取与指定叶子相邻的叶子
+     *
+     * @param leaf 叶子编号
+     * @return 相邻叶子编号序列
+     */
+    std::vector<int> adjacent(int leaf) const;
+
+    bool empty() const;
+
+    int rows() const;
+
+    int cols() const;
+
+private:
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 每个格子所属的叶子编号
+     */
+    std::vector<int> owner;
+
+    /**
+     * @brief 叶子邻接表（压缩行存储）
+     */
+    std::vector<int> link_start;
+    std::vector<int> links;
+
+    void divide(const SqPlain& graph, int x, int y, int size, double tolerance);
+
+    void connect();
+};
+
+/**
+ * @brief 在四叉树叶子上进行A*搜索并细化为格子路径
+ *
+ * @param graph 原始地图
+ * @param tree 由graph构建的四叉树
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 从起点到终点的格子路径
+ */
+std::vector<Intex> quad_star(const SqPlain& graph, const QuadTree& tree, const Intex& start, const Intex& goal);
+
+std::vector<Intex> quad_star(const Ground& ground, const QuadTree& tree, const Intex& start, const Intex& goal);
+
+#endif
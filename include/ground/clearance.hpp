@@ -0,0 +1,92 @@
+#ifndef CLEARANCE_HPP
+#define CLEARANCE_HPP
+
+class Clearance;
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+#include "utils/bitmap.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 到最近障碍的欧氏距离场
+ * 采用Felzenszwalb-Huttenlocher精确距离变换，先按列求竖直距离，再按行求下包络，
+ * 保存平方距离，查询为常数时间
+ */
+class Clearance {
+public:
+    Clearance();
+
+    /**
+     * @brief 构造函数，对障碍位图做距离变换
+     *
+     * @param obstacles 障碍位图
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    explicit Clearance(const Bitmap& obstacles, int threads=0);
+
+    /**
+     * @brief 重新计算整张距离场
+     *
+     * @param obstacles 障碍位图
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    void rebuild(const Bitmap& obstacles, int threads=0);
+
+    /**
+     * @brief 单个格子的障碍状态改变后更新距离场
+     *
+     * @param obstacles 修改后的障碍位图
+     * @param cell 被修改的格子
+     */
+    void update(const Bitmap& obstacles, const Intex& cell);
+
+    /**
+     * @brief 格子中心到最近障碍格子中心的距离
+     *
+     * @param cell 格子坐标
+     * @return 欧氏距离，障碍格子为0，越界或地图内没有障碍时为无穷大
+     */
+    double distance(const Intex& cell) const;
+
+    /**
+     * @brief 判断格子到最近障碍的距离是否不小于margin
+     */
+    bool clear(const Intex& cell, double margin) const;
+
+    int rows() const;
+
+    int cols() const;
+
+    bool empty() const;
+
+private:
+    /**
+     * @brief 表示没有障碍的平方距离
+     */
+    static constexpr int64_t far = std::numeric_limits<int64_t>::max() / 4;
+
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 每个格子到同一列最近障碍的行距离，没有障碍时为-1
+     */
+    std::vector<int> vertical;
+
+    /**
+     * @brief 每个格子到最近障碍的平方距离
+     */
+    std::vector<int64_t> squared;
+
+    void column(const Bitmap& obstacles, int y);
+
+    void row(int x, std::vector<int64_t>& f, std::vector<int>& hull, std::vector<double>& bound);
+};
+
+#endif
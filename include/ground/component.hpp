@@ -0,0 +1,129 @@
+#ifndef COMPONENT_HPP
+#define COMPONENT_HPP
+
+class Components;
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <unordered_set>
+
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 可通行格子的四连通分量索引
+ * 基于并查集，构建后所有格子直接指向代表元，查询两点是否连通为常数时间；
+ * 封堵后无法局部确认连通时不立即重建，而是在下次查询时只重新标记受影响的分量
+ */
+class Components {
+public:
+    Components();
+
+    /**
+     * @brief 构造函数，对地图进行连通分量标记
+     *
+     * @param graph 二维地图对象
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    explicit Components(const SqPlain& graph, int threads=0);
+
+    /**
+     * @brief 重新标记整张地图
+     *
+     * @param graph 二维地图对象
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    void rebuild(const SqPlain& graph, int threads=0);
+
+    /**
+     * @brief 单个格子的可通行性改变后更新索引
+     *
+     * @param graph 修改后的地图
+     * @param cell 被修改的格子
+     */
+    void update(const SqPlain& graph, const Intex& cell);
+
+    /**
+     * @brief 格子所在连通分量的代表元编号，有待重新标记的分量时先重新标记
+     *
+     * @param cell 格子坐标
+     * @return 代表元编号，越界或不可通行时返回-1
+     */
+    int label(const Intex& cell) const;
+
+    /**
+     * @brief 判断两个格子是否连通
+     *
+     * @param a 格子坐标
+     * @param b 格子坐标
+     * @return 两者都可通行且位于同一连通分量时返回true
+     */
+    bool connected(const Intex& a, const Intex& b) const;
+
+    bool empty() const;
+
+private:
+    /**
+     * @brief 局部修复时搜索的最大格子数，超过后把相邻格子记为待重新标记的种子
+     */
+    static constexpr int repair_limit = 4096;
+
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 每个格子对应的并查集节点
+     * 格子被封堵时换成新的孤立节点，旧节点只作为原集合内部的中转，
+     * 之后重新开放的格子不会经由旧节点并入已经断开的集合
+     */
+    mutable std::vector<int> node;
+
+    /**
+     * @brief 并查集父节点，前rows * cols个节点在重建时与格子一一对应，其后为封堵或重新标记时追加的节点
+     */
+    mutable std::vector<int> parent;
+
+    /**
+     * @brief 代表元所在集合的大小，用于按大小合并
+     */
+    mutable std::vector<int> weight;
+
+    std::vector<uint8_t> passable;
+
+    /**
+     * @brief 待重新标记的种子格子
+     * 某次封堵未能局部确认连通后，之后每次封堵的相邻可通行格子都记为种子；
+     * 被拆开的每一块都与某次记下的封堵相邻，从种子出发的洪水填充恰好覆盖这些块，
+     * 其余格子的标记仍然正确。复制时一并带走
+     */
+    struct Pending {
+        std::mutex lock;
+        std::atomic<bool> dirty{false};
+        std::vector<int> seeds;
+
+        Pending() = default;
+        Pending(const Pending& other);
+        Pending& operator=(const Pending& other);
+    };
+
+    mutable Pending pending;
+
+    int find(int id) const;
+
+    void unite(int a, int b);
+
+    bool repair(const SqPlain& graph, int id);
+
+    void mark(const SqPlain& graph, int id);
+
+    void settle() const;
+
+    void relabel() const;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef EROSION_HPP
+#define EROSION_HPP
+
+class Erosion;
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "robot/footprint.hpp"
+#include "robot/stencil.hpp"
+#include "utils/bitmap.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 按足部形状腐蚀后的可落足位图
+ * 对若干量化朝向分别预计算：某格为1表示以该格为中心、该朝向放置的足部完全落在可通行格子上。
+ * 结果每个朝向一张位图，共占headings × rows × ⌈cols / 64⌉ × 8字节；
+ * 构造时每个朝向另需足部区间宽度种数张同尺寸位图作临时窗口，处理完该朝向即释放
+ */
+class Erosion {
+public:
+    Erosion();
+
+    /**
+     * @brief 构造函数，对障碍位图按足部形状做腐蚀
+     *
+     * @param obstacles 障碍位图
+     * @param length 足部长度
+     * @param width 足部宽度
+     * @param headings 朝向量化数目，覆盖[0, π)
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    Erosion(const Bitmap& obstacles, double length, double width, int headings=16, int threads=0);
+
+    /**
+     * @brief 朝向角对应的量化编号
+     */
+    int heading(double rz) const;
+
+    /**
+     * @brief 量化编号对应的朝向角
+     */
+    double angle(int heading) const;
+
+    /**
+     * @brief 判断足部能否以centre为中心、以量化朝向放置
+     *
+     * @param centre 足部中心格子
+     * @param heading 朝向量化编号
+     * @return 足部覆盖的格子都在地图内且可通行时返回true
+     */
+    bool fits(const Intex& centre, int heading) const;
+
+    /**
+     * @brief 判断足部能否放置，朝向取最近的量化朝向
+     */
+    bool fits(const SqDot& centre, double rz) const;
+
+    /**
+     * @brief 某个量化朝向下足部覆盖区域的行区间
+     */
+    const std::vector<FootSpan>& footprint(int heading) const;
+
+    int headings() const;
+
+    bool empty() const;
+
+private:
+    int bucket_count;
+    std::vector<std::vector<FootSpan>> spans;
+    std::vector<Bitmap> layers;
+
+    void erode(const Bitmap& obstacles, int heading, int threads);
+};
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef FOOTHOLD_HPP
+#define FOOTHOLD_HPP
+
+class Footholds;
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "ground/ground.hpp"
+#include "ground/erosion.hpp"
+#include "robot/footprint.hpp"
+#include "utils/bitmap.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/io.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 全图的可落足位图
+ * 对每个量化朝向预计算一层位图：某格为1表示以该格为中心、该朝向放置的足部
+ * 不压障碍且拟合平面的倾角不超过上限，落足判断只需一次位测试
+ */
+class Footholds {
+public:
+    /**
+     * @brief 默认的朝向量化数目
+     */
+    static constexpr int default_headings = 16;
+
+    Footholds();
+
+    /**
+     * @brief 构造函数，先按足部形状腐蚀障碍，再对剩余格子并行做坡度判断
+     *
+     * @param ground 地面对象
+     * @param length 足部长度
+     * @param width 足部宽度
+     * @param headings 朝向量化数目，覆盖[0, π)
+     * @param limit 拟合平面允许的最大倾角（弧度）
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    Footholds(const Ground& ground, double length, double width, int headings=default_headings,
+              double limit=M_PI * 20.0 / 180.0, int threads=0);
+
+    /**
+     * @brief 把朝向角量化到[0, π)内headings份中最近的一份
+     * 足部矩形旋转π后不变，第h份与StencilCache::shared(2 * headings)的第h份朝向相同
+     *
+     * @param rz 朝向角（弧度）
+     * @param headings 朝向量化数目
+     * @return 量化编号
+     */
+    static int quantize(double rz, int headings);
+
+    /**
+     * @brief 朝向角对应的量化编号
+     */
+    int heading(double rz) const;
+
+    /**
+     * @brief 量化编号对应的朝向角
+     */
+    double angle(int heading) const;
+
+    /**
+     * @brief 判断足部能否以centre为中心、以量化朝向落足
+     */
+    bool fits(const Intex& centre, int heading) const;
+
+    /**
+     * @brief 判断足部能否落足，朝向取最近的量化朝向
+     */
+    bool fits(const SqDot& centre, double rz) const;
+
+    /**
+     * @brief 判断位图是否由该地面的当前高度构建
+     *
+     * @param ground 地面对象
+     * @return 尺寸与高度指纹都一致时返回true
+     */
+    bool matches(const Ground& ground) const;
+
+    /**
+     * @brief 地图高度的指纹，用于判断持久化的位图是否过期
+     */
+    static uint64_t fingerprint(const SqPlain& graph);
+
+    /**
+     * @brief 将位图写入二进制文件
+     *
+     * @param filename 文件路径
+     * @return 写入成功返回true
+     */
+    bool save(const std::string& filename) const;
+
+    /**
+     * @brief 从二进制文件读取位图
+     *
+     * 文件头或数据长度不匹配时保持原位图不变
+     *
+     * @param filename 文件路径
+     * @return 读取成功返回true
+     */
+    bool load(const std::string& filename);
+
+    double length() const;
+
+    double width() const;
+
+    double limit() const;
+
+    int headings() const;
+
+    int rows() const;
+
+    int cols() const;
+
+    bool empty() const;
+
+private:
+    int row_count;
+    int col_count;
+    int bucket_count;
+    double foot_length;
+    double foot_width;
+    double max_angle;
+    uint64_t print;
+    std::vector<Bitmap> layers;
+};
+
+#endif
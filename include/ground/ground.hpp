@@ -1,16 +1,49 @@
 #ifndef GROUND_HPP
 #define GROUND_HPP 
 
+enum class TripMode;
 class Ground;
 
 #include <vector>
 #include <iostream>
 #include <array>
 #include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 #include "csv/reader.hpp"
+#include "ground/component.hpp"
+#include "utils/bitmap.hpp"
+#include "ground/clearance.hpp"
+#include "ground/plane.hpp"
+#include "ground/slope.hpp"
+#include "ground/sampler.hpp"
+#include "robot/footprint.hpp"
 #include "robot/foot.hpp"
 #include "utils/geometry.hpp"
+#include "utils/batch.hpp"
+
+/**
+ * @brief 接触平面的拟合方式
+ */
+enum class TripMode {
+    /**
+     * @brief 三点迭代替换，贴合区域内最高的点
+     */
+    Iterative,
+
+    /**
+     * @brief 由累计矩直接求最小二乘平面，O(n)
+     */
+    LeastSquares,
+
+    /**
+     * @brief 凸包上位于区域重心正上方的支撑面，见convex_trip
+     */
+    Convex
+};
 
 class Ground {
 public:
@@ -21,16 +54,43 @@ public:
 
     SqPlain map;
     
-    CuPlain trip(std::vector<SqDot>& area);
+    CuPlain trip(const std::vector<SqDot>& area, TripMode mode=TripMode::Iterative) const;
+
+    /**
+     * @brief 对按行区间给出的区域做最小二乘平面拟合
+     * 
+     * 每行的矩取自高度前缀和，复杂度与行数成正比
+     * 
+     * @param spans 区域的行区间
+     * @param count 行数
+     * @return 拟合得到的平面，区域越界或点数不足时返回CuPlain()
+     */
+    CuPlain trip(const FootSpan* spans, int count) const;
+
+    /**
+     * @brief 在实数坐标的足部矩形内均匀取样插值高度，做最小二乘平面拟合
+     * 
+     * 取样点不必落在格子上，旋转后的足部也无需加密网格
+     * 
+     * @param centre 足部中心
+     * @param rz 足部朝向角（弧度）
+     * @param length 足部长度
+     * @param width 足部宽度
+     * @param step 取样间距（格）
+     * @param mode 插值方式
+     * @return 拟合得到的平面，取样点越界或落在障碍上时返回CuPlain()
+     */
+    CuPlain sample_trip(const SqDot& centre, double rz, double length, double width, double step=0.5,
+                        Interpolation mode=Interpolation::Bilinear) const;
     
     
-    CuDot normal(std::vector<SqDot>& area);
+    CuDot normal(const std::vector<SqDot>& area, TripMode mode=TripMode::Iterative) const;
     
     
-    CuPlain convex_trip(std::vector<SqDot>& area);
+    CuPlain convex_trip(const std::vector<SqDot>& area) const;
     
     
-    double stand_angle(std::vector<SqDot>& area);
+    double stand_angle(const std::vector<SqDot>& area, TripMode mode=TripMode::Iterative) const;
 
     
     std::array<int, 2> shape() const;
@@ -44,11 +104,113 @@ public:
 
     bool obstacle(const int& x, const int& y) const;
 
+    /**
+     * @brief 格子是否可以进入，与map.edge_allowed等价，读取障碍位图
+     */
+    bool edge_allowed(const Intex& point) const;
+
     bool set_unit(const int& x, const int& y, bool is_obstacle);
 
+    /**
+     * @brief 地图版本号，每次通过set_unit修改地图后递增
+     * 直接修改map的调用者需要自行调用touch
+     */
+    uint64_t version() const;
+
+    /**
+     * @brief 直接修改map后调用，递增版本号并重新标记连通分量
+     */
+    void touch();
+
+    /**
+     * @brief 地面对象的唯一编号，复制或赋值得到的对象使用新的编号
+     * 与version一起标识地图内容，供跨地图共享的缓存区分不同的地面
+     */
+    uint64_t id() const;
+
+    /**
+     * @brief 判断两个格子之间是否存在可通行路径，常数时间
+     *
+     * @param start 起点坐标
+     * @param goal 终点坐标
+     * @return 两者位于同一连通分量时返回true
+     */
+    bool reachable(const Intex& start, const Intex& goal) const;
+
+    const Components& components() const;
+
+    /**
+     * @brief 与map同步的障碍位图，不可通行的格子置1
+     */
+    const Bitmap& obstacles() const;
+
+    /**
+     * @brief 与map同步的到最近障碍距离场
+     */
+    const Clearance& clearance() const;
+
+    /**
+     * @brief 与map同步的逐格梯度与坡度角
+     *
+     * 首次请求时才建表，此后由set_unit增量维护，touch后丢弃；
+     * 返回的引用在下一次touch前有效
+     */
+    const SlopeMap& slope() const;
+
+    /**
+     * @brief 判断足部区域的站立角度是否不超过limit
+     * 
+     * 由高度前缀和对区域做最小二乘拟合，复杂度与行数成正比，结论是精确的；
+     * 梯度表的平均坡度与区域的拟合平面不一致，只能用于排序，不能用于判断
+     * 
+     * @param spans 足部区域的行区间
+     * @param count 行数
+     * @param limit 最大站立角度（弧度）
+     * @return 站立角度不超过limit时返回true，区域越界或无法拟合时返回false
+     */
+    bool stand_check(const FootSpan* spans, int count, double limit=M_PI * 20.0 / 180.0) const;
+
     int rows() const;
 
     int cols() const;
+
+private:
+    /**
+     * @brief 进程内唯一的编号，复制时重新分配
+     */
+    struct Serial {
+        uint64_t value;
+
+        Serial();
+        Serial(const Serial&);
+        Serial& operator=(const Serial&);
+    };
+
+    Serial serial;
+
+    uint64_t revision;
+
+    Components regions;
+
+    Bitmap blocked;
+
+    Clearance room;
+
+    HeightSums sums;
+
+    /**
+     * @brief 按需建立的坡度表，复制时不带走已建的表
+     */
+    struct SlopeCache {
+        std::mutex lock;
+        std::unique_ptr<SlopeMap> table;
+
+        SlopeCache() = default;
+        SlopeCache(const SlopeCache&);
+        SlopeCache& operator=(const SlopeCache&);
+    };
+
+    mutable SlopeCache slopes;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef PLANE_HPP
+#define PLANE_HPP
+
+struct PlaneMoments;
+class HeightSums;
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <random>
+
+#include "utils/geometry.hpp"
+
+/**
+ * @brief 拟合平面 z = a * x + b * y + c 所需的一阶、二阶矩
+ */
+struct PlaneMoments {
+    double n = 0.0;
+    double sx = 0.0;
+    double sy = 0.0;
+    double sz = 0.0;
+    double sxx = 0.0;
+    double syy = 0.0;
+    double sxy = 0.0;
+    double sxz = 0.0;
+    double syz = 0.0;
+
+    /**
+     * @brief 高度不是有限值或是障碍的点数，大于0时无法拟合
+     */
+    int invalid = 0;
+
+    void add(double x, double y, double z);
+
+    void merge(const PlaneMoments& other);
+
+    /**
+     * @brief 最小二乘平面
+     *
+     * @return 法向量z分量为1的平面，点数不足、共线或含无效高度时返回CuPlain()
+     */
+    CuPlain fit() const;
+};
+
+/**
+ * @brief 刚性足部在点集上的支撑平面
+ *
+ * 支撑平面是点集上凸包的一个面，位于点集xy重心的正上方，
+ * 等价于在所有不低于各点的平面中使重心处高度最小
+ *
+ * @param dots 点集
+ * @param count 点数
+ * @return 法向量z分量为1的平面，点数不足、xy共线或含无效高度时返回CuPlain()
+ */
+CuPlain support_plane(const CuDot* dots, int count);
+
+/**
+ * @brief 按行的高度前缀和
+ * 任意一行中连续区间的平面矩可以在常数时间内得到
+ */
+class HeightSums {
+public:
+    HeightSums();
+
+    explicit HeightSums(const SqPlain& graph);
+
+    /**
+     * @brief 地图第x行修改后重新计算该行
+     */
+    void update(const SqPlain& graph, int x);
+
+    /**
+     * @brief 第x行[y0, y1]区间的平面矩
+     *
+     * @return 区间越界时invalid为区间长度
+     */
+    PlaneMoments span(int x, int y0, int y1) const;
+
+    bool empty() const;
+
+private:
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 第x行前k个格子的 Σz、Σy·z 与无效格子数，按 x * (cols + 1) + k 排列，
+     * 高度不是有限值或是障碍的格子记为无效
+     */
+    std::vector<double> z_sum;
+    std::vector<double> yz_sum;
+    std::vector<int> bad_sum;
+};
+
+#endif
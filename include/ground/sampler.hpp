@@ -0,0 +1,106 @@
+#ifndef SAMPLER_HPP
+#define SAMPLER_HPP
+
+class HeightSampler;
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include "utils/batch.hpp"
+#include "utils/bitmap.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+
+/**
+ * @brief 高度插值方式
+ */
+enum class Interpolation { Nearest, Bilinear, Bicubic };
+
+/**
+ * @brief 实数坐标处的高度插值
+ * 格子(x, y)的高度位于坐标(x, y)处，可取样范围为[0, rows - 1] × [0, cols - 1]；
+ * 插值用到的格子中有障碍（权重不为0）或坐标越界时结果为NaN。
+ * 取样器是地图与障碍位图的视图，不复制高度，只应作为局部对象在两者的作用域内使用：
+ * 不能由临时对象构造，也不能复制或移动；尺寸每次调用时重新读取，
+ * 地图与位图尺寸不一致（如touch改变尺寸的中途）时视为空取样器
+ */
+class HeightSampler {
+public:
+    HeightSampler();
+
+    /**
+     * @brief 构造函数
+     *
+     * @param graph 二维地图对象
+     * @param blocked 与graph同尺寸的障碍位图，障碍格子置1
+     */
+    HeightSampler(const SqPlain& graph, const Bitmap& blocked);
+
+    HeightSampler(SqPlain&&, const Bitmap&) = delete;
+    HeightSampler(const SqPlain&, Bitmap&&) = delete;
+    HeightSampler(const HeightSampler&) = delete;
+    HeightSampler& operator=(const HeightSampler&) = delete;
+
+    /**
+     * @brief 单点插值
+     *
+     * @param x x坐标
+     * @param y y坐标
+     * @param mode 插值方式，Bicubic为Catmull-Rom样条，边界外的邻格取最近的边界格
+     * @return 高度，越界或用到障碍格子时为NaN
+     */
+    double sample(double x, double y, Interpolation mode=Interpolation::Bilinear) const;
+
+    /**
+     * @brief 批量插值
+     *
+     * 每64个点一组，依次做权重、取数、合成三遍：权重与合成两遍只有算术与选择，
+     * 可以向量化；取数一遍按格子编号读地图与位图，是逐点的间接读取；
+     * 插值方式在循环外选定
+     *
+     * @param x 各点x坐标
+     * @param y 各点y坐标
+     * @param count 点数
+     * @param out 输出高度，无效点为NaN
+     * @param mode 插值方式
+     * @return 有效点数
+     */
+    int sample(const double* x, const double* y, int count, double* out, Interpolation mode=Interpolation::Bilinear) const;
+
+    /**
+     * @brief 按点集的x、y坐标插值，结果写入z
+     *
+     * @return 有效点数
+     */
+    int sample(PointBatch& points, Interpolation mode=Interpolation::Bilinear) const;
+
+    int rows() const;
+
+    int cols() const;
+
+    bool empty() const;
+
+private:
+    const SqPlain* graph;
+    const Bitmap* blocked;
+
+    /**
+     * @brief 格子高度，障碍格子为0，不让无穷大的障碍高度经0权重变成NaN
+     */
+    double height(int x, int y) const;
+
+    /**
+     * @brief 障碍格子为1，否则为0
+     */
+    double bad(int x, int y) const;
+
+    void bilinear(const double* x, const double* y, int count, double* out) const;
+
+    void bicubic(const double* x, const double* y, int count, double* out) const;
+
+    void nearest(const double* x, const double* y, int count, double* out) const;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SLOPE_HPP
+#define SLOPE_HPP
+
+class SlopeMap;
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "ground/plane.hpp"
+#include "robot/footprint.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 逐格的地形梯度与坡度角
+ * 每格取3×3邻域内非障碍格子的最小二乘平面 z = a * x + b * y + c 的斜率(a, b)，障碍格子无法拟合，
+ * 单格梯度以float逐格保存；另按行保存梯度前缀和，只用于足部区域的平均梯度，可按行常数时间求得
+ */
+class SlopeMap {
+public:
+    SlopeMap();
+
+    /**
+     * @brief 构造函数，按行并行计算全图梯度
+     *
+     * @param graph 二维地图对象
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    explicit SlopeMap(const SqPlain& graph, int threads=0);
+
+    /**
+     * @brief 格子(x, y)修改后更新其3×3邻域
+     */
+    void update(const SqPlain& graph, const Intex& cell);
+
+    /**
+     * @brief 格子的单位法向量（z分量为正）
+     */
+    CuDot normal(const Intex& cell) const;
+
+    /**
+     * @brief 格子的坡度角（弧度），无法拟合时为无穷大
+     */
+    double angle(const Intex& cell) const;
+
+    /**
+     * @brief 区域内各格梯度的平均值对应的坡度角
+     *
+     * @param spans 区域的行区间
+     * @param count 行数
+     * @return 坡度角（弧度），区域越界或含无法拟合的格子时为无穷大
+     */
+    double mean_angle(const FootSpan* spans, int count) const;
+
+    bool empty() const;
+
+private:
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 按 x * cols + y 排列的单格梯度，无法拟合的格子为NaN
+     */
+    std::vector<float> cell_x;
+    std::vector<float> cell_y;
+
+    /**
+     * @brief 按 x * (cols + 1) + k 排列的每行前k格梯度之和与无效格数，无法拟合的格子梯度记为0
+     */
+    std::vector<double> sum_x;
+    std::vector<double> sum_y;
+    std::vector<int> bad;
+
+    bool fit(const SqPlain& graph, int x, int y, double& a, double& b) const;
+    void build(const SqPlain& graph, int x);
+    bool gradient(const Intex& cell, double& a, double& b) const;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef SWING_HPP
+#define SWING_HPP
+
+class SwingTable;
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 线段经过格子的最大高度查询
+ * 按行、按列各保存一份稀疏表：第k层记录从每格开始连续2^k格的最大高度，
+ * 线段沿较短的坐标轴拆成若干行（或列）区间，每个区间常数次查表；
+ * 不可通行的格子高度视为无穷大，摆动足无法越过。
+ * 表中高度以float保存并向上取整，查询结果不低于真实高度，越障判断只会偏保守
+ */
+class SwingTable {
+public:
+    SwingTable();
+
+    /**
+     * @brief 构造函数，按行、按列并行建表
+     *
+     * @param graph 二维地图对象
+     * @param reach 单次查表覆盖的区间长度上限，表的层数取到不小于reach的2的幂，更长的区间分段查表；
+     *              内存为每格 2 × levels × 4 字节，levels = ceil(log2(reach)) + 1，
+     *              默认64时为每格56字节，300万格的地图约168MB，reach每减半少8字节
+     * @param threads 线程数，不大于0时使用hardware_threads()
+     */
+    explicit SwingTable(const SqPlain& graph, int reach=64, int threads=0);
+
+    /**
+     * @brief 格子修改后重建所在行与所在列的表
+     */
+    void update(const SqPlain& graph, const Intex& cell);
+
+    /**
+     * @brief 格子高度（向上取整到float），不可通行时为无穷大，越界时为NaN
+     */
+    double height(const Intex& cell) const;
+
+    /**
+     * @brief 第x行[y0, y1]内的最大高度，区间会被裁剪到地图范围内，为空时返回负无穷
+     */
+    double row_max(int x, int y0, int y1) const;
+
+    /**
+     * @brief 第y列[x0, x1]内的最大高度，区间会被裁剪到地图范围内，为空时返回负无穷
+     */
+    double col_max(int y, int x0, int x1) const;
+
+    /**
+     * @brief 两格子中心连线经过的格子的最大高度
+     *
+     * 线段经过的格子与Bitmap::sight一致，只擦过格子角点时不计入
+     *
+     * @param from 起点格子
+     * @param to 终点格子
+     * @return 最大高度，端点越界时为无穷大
+     */
+    double segment_max(const Intex& from, const Intex& to) const;
+
+    /**
+     * @brief 判断高度为height的水平线段能否越过from到to之间的地形
+     */
+    bool clears(const Intex& from, const Intex& to, double height) const;
+
+    int rows() const;
+
+    int cols() const;
+
+    bool empty() const;
+
+private:
+    int row_count;
+    int col_count;
+    int levels;
+
+    /**
+     * @brief 第k层按 k * cells + x * cols + y 排列，为第x行[y, y + 2^k)的最大高度
+     */
+    std::vector<float> by_row;
+
+    /**
+     * @brief 第k层按 k * cells + y * rows + x 排列，为第y列[x, x + 2^k)的最大高度
+     */
+    std::vector<float> by_col;
+
+    void build_row(int x);
+
+    void build_col(int y);
+
+    /**
+     * @brief 在一行（或一列）的稀疏表上查询[lo, hi]的最大值，区间非空且在范围内
+     *
+     * @param table by_row或by_col
+     * @param offset 该行（或列）第0格在第0层中的下标
+     */
+    double range_max(const std::vector<float>& table, size_t offset, int lo, int hi) const;
+};
+
+#endif
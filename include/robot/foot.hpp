@@ -1,6 +1,7 @@
 #ifndef FOOT_HPP
 #define FOOT_HPP
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <unordered_set>
@@ -8,9 +9,33 @@
 
 #include "utils/geometry.hpp"
 #include "ground/ground.hpp"
+#include "robot/footprint.hpp"
+#include "robot/stencil.hpp"
 
 enum class SlideResult { Modified, NoModification, NotApplicable };
 
+/**
+ * @brief 足部位置细化的结果
+ */
+struct SettleResult {
+    SlideResult result;
+
+    /**
+     * @brief 细化后的足部中心
+     */
+    SqDot position;
+
+    /**
+     * @brief 该位置拟合平面的倾角（弧度），足部越界或压障碍时为无穷大
+     */
+    double angle;
+
+    /**
+     * @brief 本次细化做过的平面拟合次数
+     */
+    int fits;
+};
+
 class Foot;
 
 #include "robot/foot.hpp"
@@ -53,13 +78,21 @@ public:
     /**
      * @brief 滑动调整足部落足区域以提高稳定性
      * 
-     * 根据地面法向量调整足部的落足区域，以获得更好的稳定性
+     * 在radius范围内按坡度表选择下降方向，找到站立角度更小的位置；
+     * 下降没有离开原位时，再比较沿法向量水平分量正反平移1至3倍的位置中坡度估计最小的三个
      * 
      * @param area 足部落足区域
      * @param ground 地形对象
+     * @param radius 最大平移距离（格）
+     * @param fits 精确拟合次数
      * @return 滑动调整结果
      */
-    SlideResult slide(std::vector<SqDot>& area, Ground& ground);
+    SlideResult slide(std::vector<SqDot>& area, const Ground& ground, int radius, int& fits);
+
+    /**
+     * @brief 滑动调整足部落足区域以提高稳定性，不统计拟合次数
+     */
+    SlideResult slide(std::vector<SqDot>& area, const Ground& ground, int radius=3);
 };
 
 /**
@@ -117,22 +150,63 @@ public:
     double direction_delta(const Foot& other) const;
 
     /**
-     * @brief 计算足部在特定朝向下的覆盖区域
+     * @brief 计算足部覆盖的格子
      * 
-     * @param rz_of_foot 足部朝向角（弧度）
      * @return 足部覆盖的点集合
      */
     std::vector<SqDot> cover() const;
 
+    /**
+     * @brief 按行输出足部覆盖的格子，不分配内存
+     * 
+     * @param out 输出缓冲区
+     * @param capacity 缓冲区容量
+     * @return 写入的行数，容量不足时返回-1
+     */
+    int spans(FootSpan* out, int capacity) const;
+
+    /**
+     * @brief 足部尺寸与量化朝向对应的共享模板
+     * 
+     * @return 以格子(0, 0)为中心的模板，朝向取最近的量化朝向
+     */
+    const Stencil& stencil() const;
+
     std::vector<SqDot> corner() const;
 
+    /**
+     * @brief 足部矩形的包围盒是否在地图内，此时覆盖的格子都不越界
+     */
+    bool inside(const Ground& ground) const;
+
+    /**
+     * @brief 检查足部覆盖的格子到最近障碍的距离是否都不小于margin
+     * 
+     * @param ground 地形对象
+     * @param margin 最小距离
+     * @return 全部满足时返回true，足部中心越界时返回false
+     */
+    bool clear(const Ground& ground, double margin) const;
+
+    /**
+     * @brief 在radius范围内把足部中心移到拟合平面更平的格子
+     * 
+     * 按坡度表估计的平均坡度选择下降方向，只对最有希望的邻居做平面拟合，
+     * 同一次查询内每个位置最多拟合一次；足部越界或压障碍的位置不会被选中
+     * 
+     * @param ground 地形对象
+     * @param radius 最大平移距离（格）
+     * @return 细化结果，找不到更平的位置时position为原位置
+     */
+    SettleResult settle(const Ground& ground, int radius=3) const;
+
     /**
      * @brief 让足部走向指定位置
      * 
      * @param ground 地形对象
      * @return 如果成功走向指定位置返回true，否则返回false
      */
-    bool walkto(Ground& ground);
+    bool walkto(const Ground& ground);
 };
 
 #endif
\ No newline at end of file
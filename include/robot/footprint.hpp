@@ -0,0 +1,59 @@
+#ifndef FOOTPRINT_HPP
+#define FOOTPRINT_HPP
+
+struct FootSpan;
+
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @brief 足部覆盖区域中一行的连续列区间
+ */
+struct FootSpan {
+    int x;
+    int y0;
+    int y1;
+};
+
+/**
+ * @brief 足部覆盖区域的最大行数，足够容纳边长不超过60格的足部
+ */
+constexpr int footprint_rows = 96;
+
+/**
+ * @brief 精确光栅化旋转后的足部矩形
+ *
+ * 格子(i, j)占据[i - 0.5, i + 0.5] × [j - 0.5, j + 0.5]，与矩形的交集面积为正时视为被覆盖；
+ * 结果按行从小到大写入调用者提供的缓冲区，不分配内存，只计算一次三角函数
+ *
+ * @param cx 足部中心x坐标
+ * @param cy 足部中心y坐标
+ * @param rz 足部朝向角（弧度）
+ * @param length 足部长度
+ * @param width 足部宽度
+ * @param spans 输出缓冲区
+ * @param capacity 缓冲区容量
+ * @return 写入的行数，容量不足时返回-1
+ */
+int rasterize_foot(double cx, double cy, double rz, double length, double width, FootSpan* spans, int capacity);
+
+/**
+ * @brief 计算rasterize_foot输出的每个格子被足部覆盖的面积比例
+ *
+ * 权重按行、列顺序写入，与逐行展开spans的顺序一致，取值在(0, 1]之间
+ *
+ * @param cx 足部中心x坐标
+ * @param cy 足部中心y坐标
+ * @param rz 足部朝向角（弧度）
+ * @param length 足部长度
+ * @param width 足部宽度
+ * @param spans rasterize_foot的输出
+ * @param count 行数
+ * @param weights 输出缓冲区
+ * @param capacity 缓冲区容量
+ * @return 写入的格子数，容量不足时返回-1
+ */
+int foot_weights(double cx, double cy, double rz, double length, double width,
+                 const FootSpan* spans, int count, double* weights, int capacity);
+
+#endif
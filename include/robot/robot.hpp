@@ -11,6 +11,8 @@ enum class WhichFoot;
 #include "robot/foot.hpp"
 #include "utils/geometry.hpp"
 #include "aStar/aStar.hpp"
+#include "ground/foothold.hpp"
+#include "ground/swing.hpp"
 
 /**
  * @brief 足部枚举，表示左脚或右脚
@@ -178,6 +180,18 @@ public:
      * @return 如果满足限制条件返回true，否则返回false
      */
     bool satisfy_turn(const SqDot& new_pos);
+
+    /**
+     * @brief 检查摆动脚移到新位置的途中能否越过地形
+     * 
+     * 摆动脚抬到两端落足点中较高者之上lift处，两落足点中心连线经过的格子都不能高于该高度
+     * 
+     * @param table 与地面同步的线段最大高度表
+     * @param new_pos 新位置
+     * @param lift 抬脚高度
+     * @return 能越过时返回true，端点越界或不可通行时返回false
+     */
+    bool satisfy_swing(const SwingTable& table, const SqDot& new_pos, double lift);
     
     /**
      * @brief 滑动调整足部落足区域
@@ -188,7 +202,7 @@ public:
      * @param ground 地形对象
      * @return 滑动调整结果
      */
-    SlideResult slide(std::vector<SqDot>& area, Ground& ground);
+    SlideResult slide(std::vector<SqDot>& area, const Ground& ground);
 
     
     /**
@@ -204,11 +218,24 @@ public:
     /**
      * @brief 调整目标点以适应地形约束
      * 
+     * 在goal周围max_foot_separation范围内由近到远查找摆动脚能落足的格子，
+     * 朝向取支撑脚指向goal的方向
+     * 
      * @param ground 地形对象
      * @param goal 原始目标点
-     * @return 调整后的目标点
+     * @param headings 朝向量化数目，与Footholds相同时两个重载选出同一格子
+     * @return 调整后的目标点，找不到时返回摆动脚当前位置
+     */
+    SqDot fit_target(const Ground& ground, const SqDot& goal, int headings=Footholds::default_headings);
+
+    /**
+     * @brief 调整目标点以适应地形约束，落足判断查预计算的可落足位图
+     * 
+     * @param footholds 按摆动脚尺寸构建的可落足位图
+     * @param goal 原始目标点
+     * @return 调整后的目标点，找不到时返回摆动脚当前位置
      */
-    SqDot fit_target(const Ground& ground, const SqDot& goal);
+    SqDot fit_target(const Footholds& footholds, const SqDot& goal);
 
     
     /**
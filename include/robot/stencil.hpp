@@ -0,0 +1,131 @@
+#ifndef STENCIL_HPP
+#define STENCIL_HPP
+
+struct Stencil;
+class StencilCache;
+
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <cmath>
+#include <cstdint>
+
+#include "robot/footprint.hpp"
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+
+/**
+ * @brief 以格子(0, 0)为中心、某个量化朝向下的足部模板
+ * 候选落足点的覆盖区域与角点只需把模板平移到落足点
+ */
+struct Stencil {
+    /**
+     * @brief 量化后的朝向角
+     */
+    double rz;
+
+    /**
+     * @brief 按行排列的覆盖区间
+     */
+    std::vector<FootSpan> spans;
+
+    /**
+     * @brief 按行、列顺序排列的覆盖格子偏移
+     */
+    std::vector<Intex> cells;
+
+    /**
+     * @brief 四个角点的偏移，顺序与Foot::corner一致
+     */
+    std::array<SqDot, 4> corners;
+
+    /**
+     * @brief 足部所占行数超过footprint_rows，此时不保存覆盖区间，place返回-1
+     */
+    bool oversized = false;
+
+    /**
+     * @brief 平移到centre后的覆盖格子
+     */
+    std::vector<SqDot> cover(const Intex& centre) const;
+
+    /**
+     * @brief 平移到centre后的角点
+     */
+    std::vector<SqDot> corner(const SqDot& centre) const;
+
+    /**
+     * @brief 把平移到centre后的覆盖区间写入调用者提供的缓冲区，不分配内存
+     *
+     * @param centre 足部中心格子
+     * @param out 输出缓冲区
+     * @param capacity 缓冲区容量
+     * @return 写入的行数，容量不足或模板超出footprint_rows行时返回-1
+     */
+    int place(const Intex& centre, FootSpan* out, int capacity) const;
+};
+
+/**
+ * @brief 足部模板缓存
+ * 按（足部长度，宽度，量化朝向）索引，模板创建后地址不变，可在多线程间共享
+ */
+class StencilCache {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param headings 一周内的朝向量化数目
+     */
+    explicit StencilCache(int headings=64);
+
+    /**
+     * @brief 进程共享的模板缓存，每种量化数目各一份
+     *
+     * @param headings 一周内的朝向量化数目
+     */
+    static StencilCache& shared(int headings=64);
+
+    /**
+     * @brief 朝向角对应的量化编号
+     */
+    int heading(double rz) const;
+
+    /**
+     * @brief 朝向角是否落在量化朝向上，此时模板与直接光栅化的结果相同
+     */
+    bool aligned(double rz) const;
+
+    /**
+     * @brief 获取模板，不存在时创建
+     *
+     * @param length 足部长度
+     * @param width 足部宽度
+     * @param rz 朝向角（弧度），取最近的量化朝向
+     * @return 模板
+     */
+    const Stencil& get(double length, double width, double rz);
+
+    size_t size() const;
+
+private:
+    struct Key {
+        double length;
+        double width;
+        int heading;
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    int bucket_count;
+    mutable std::mutex lock;
+    std::unordered_map<Key, std::unique_ptr<Stencil>, KeyHash> stencils;
+};
+
+#endif
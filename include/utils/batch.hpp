@@ -0,0 +1,84 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+struct PointBatch;
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+#include "utils/geometry.hpp"
+
+/**
+ * @brief 按分量分开存放的三维点集（SoA）
+ * 批量核函数逐分量连续读取，便于向量化
+ */
+struct PointBatch {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    void clear();
+
+    void push(double px, double py, double pz);
+
+    void push(const CuDot& dot);
+
+    /**
+     * @brief 删除第index个点，其余点保持原顺序
+     */
+    void erase(int index);
+
+    int size() const;
+
+    bool empty() const;
+};
+
+/**
+ * @brief 批量计算点到平面的有符号距离
+ *
+ * 法向量长度只求一次；法向量长度小于1e-9时全部为0，与CuPlain::distance一致
+ *
+ * @param plane 平面
+ * @param x 各点x坐标
+ * @param y 各点y坐标
+ * @param z 各点z坐标
+ * @param count 点数
+ * @param out 输出缓冲区，长度不小于count
+ */
+void plane_distances(const CuPlain& plane, const double* x, const double* y, const double* z, int count, double* out);
+
+void plane_distances(const CuPlain& plane, const PointBatch& points, double* out);
+
+/**
+ * @brief 批量判断点在平面的哪一侧
+ *
+ * @param plane 平面
+ * @param x 各点x坐标
+ * @param y 各点y坐标
+ * @param z 各点z坐标
+ * @param count 点数
+ * @param out 输出缓冲区，1为Above，-1为Below，0为Inside，阈值与CuPlain::get_pos一致
+ */
+void plane_sides(const CuPlain& plane, const double* x, const double* y, const double* z, int count, int8_t* out);
+
+void plane_sides(const CuPlain& plane, const PointBatch& points, int8_t* out);
+
+/**
+ * @brief 点到平面距离（绝对值）之和
+ */
+double plane_error(const CuPlain& plane, const double* x, const double* y, const double* z, int count);
+
+double plane_error(const CuPlain& plane, const PointBatch& points);
+
+/**
+ * @brief 平面上方距离最大的点
+ *
+ * @param plane 平面
+ * @param points 点集
+ * @param distance 该点到平面的距离
+ * @return 点的下标，多个点距离相同时取下标最小者，上方没有点时返回-1
+ */
+int farthest_above(const CuPlain& plane, const PointBatch& points, double& distance);
+
+#endif
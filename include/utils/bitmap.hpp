@@ -0,0 +1,113 @@
+#ifndef BITMAP_HPP
+#define BITMAP_HPP
+
+class Bitmap;
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "utils/geometry.hpp"
+#include "utils/index.hpp"
+
+/**
+ * @brief 按位压缩的二维位图
+ * 每行按64位字对齐存储，矩形计数、行区间判断等操作每次读取64个格子
+ */
+class Bitmap {
+public:
+    Bitmap();
+
+    /**
+     * @brief 构造全零位图
+     *
+     * @param rows 行数
+     * @param cols 列数
+     */
+    Bitmap(int rows, int cols);
+
+    /**
+     * @brief 由地图构造障碍位图，不可通行的格子置1
+     *
+     * @param graph 二维地图对象
+     */
+    explicit Bitmap(const SqPlain& graph);
+
+    /**
+     * @brief 由按行对齐的64位字构造位图，字数与尺寸不符时构造全零位图
+     *
+     * @param rows 行数
+     * @param cols 列数
+     * @param words 与data()布局相同的字序列
+     */
+    Bitmap(int rows, int cols, std::vector<uint64_t> words);
+
+    bool test(int x, int y) const;
+
+    void set(int x, int y, bool value);
+
+    /**
+     * @brief 统计矩形区域内置1的格子数，区域会被裁剪到位图范围内
+     *
+     * @param x0 起始行（含）
+     * @param y0 起始列（含）
+     * @param x1 终止行（含）
+     * @param y1 终止列（含）
+     * @return 置1的格子数
+     */
+    int count(int x0, int y0, int x1, int y1) const;
+
+    /**
+     * @brief 判断一行中的区间内是否存在置1的格子，区间会被裁剪到位图范围内
+     *
+     * @param x 行号
+     * @param y0 起始列（含）
+     * @param y1 终止列（含）
+     * @return 存在置1的格子时返回true
+     */
+    bool any(int x, int y0, int y1) const;
+
+    /**
+     * @brief 判断两格子中心连线经过的格子是否都为0
+     *
+     * 按行求出线段覆盖的列区间，再逐行做区间判断；线段只擦过格子角点时不计入
+     *
+     * @param from 起点格子
+     * @param to 终点格子
+     * @return 连线上没有置1的格子且两端都在范围内时返回true
+     */
+    bool sight(const Intex& from, const Intex& to) const;
+
+    int rows() const;
+
+    int cols() const;
+
+    bool empty() const;
+
+    /**
+     * @brief 按行对齐的64位字，每行(cols + 63) / 64个字，用于持久化
+     */
+    const std::vector<uint64_t>& data() const;
+
+private:
+    int row_count;
+    int col_count;
+
+    /**
+     * @brief 每行占用的64位字数
+     */
+    int stride;
+
+    std::vector<uint64_t> words;
+
+    static int popcount(uint64_t word);
+
+    /**
+     * @brief 一行中[y0, y1]区间内置1的位，逐字交给visit处理，visit返回false时提前结束
+     */
+    template <typename Visit>
+    void scan(int x, int y0, int y1, Visit visit) const;
+};
+
+#endif
@@ -77,4 +77,22 @@ inline std::string buildPath(const std::string& relativePath) {
     return IOManager::get_instance().build_path(relativePath);
 }
 
+/**
+ * @brief 按内存表示写入一个定长值，跨平台的文件格式应传入int32_t、uint64_t等定宽类型
+ */
+template <typename T>
+inline void write_value(std::ostream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief 按内存表示读取一个定长值
+ *
+ * @return 读满sizeof(T)字节时返回true
+ */
+template <typename T>
+inline bool read_value(std::istream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
 #endif
\ No newline at end of file
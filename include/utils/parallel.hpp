@@ -0,0 +1,171 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+class ThreadPool;
+class TaskGroup;
+class Barrier;
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <chrono>
+#include <algorithm>
+
+/**
+ * @brief 默认工作线程数，取硬件并发数且至少为1
+ */
+int hardware_threads();
+
+/**
+ * @brief 工作窃取线程池
+ * 每个工作线程有自己的任务队列，从队尾取自己提交的任务，空闲时从其他队列的队头窃取；
+ * 等待任务组的线程也会参与执行任务，因此在任务内部再次提交并等待不会死锁
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 构造函数
+     *
+     * @param threads 工作线程数，可以为0，此时任务全部由等待者执行
+     */
+    explicit ThreadPool(int threads);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 进程共享的线程池，工作线程数为hardware_threads() - 1，调用线程补足最后一个
+     */
+    static ThreadPool& shared();
+
+    /**
+     * @brief 提交任务，工作线程提交到自己的队列，其他线程轮流提交到各队列
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief 取出并执行一个任务
+     *
+     * @return 没有可执行的任务时返回false
+     */
+    bool run_one();
+
+    /**
+     * @brief 工作线程数
+     */
+    int size() const;
+
+private:
+    struct Queue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex lock;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> pending;
+    std::atomic<unsigned> cursor;
+    bool stopping;
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+
+    bool take(int home, std::function<void()>& task);
+    void work(int index);
+};
+
+/**
+ * @brief 任务组，等待其中提交的全部任务完成
+ * 任务抛出的第一个异常由wait重新抛出，其余异常丢弃；抛出异常的任务同样计为完成
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool=ThreadPool::shared());
+
+    /**
+     * @brief 析构时等待尚未完成的任务，不抛出任务的异常
+     */
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+
+    /**
+     * @brief 等待全部任务完成
+     *
+     * 等待期间执行线程池中的任务，取不到任务时在条件变量上阻塞，直到组内任务完成
+     * 或超过1毫秒（重新检查是否有新提交的任务）
+     *
+     * @throw 组内任务抛出的第一个异常
+     */
+    void wait();
+
+private:
+    ThreadPool& pool;
+    int outstanding;
+    std::exception_ptr failure;
+    std::mutex lock;
+    std::condition_variable done;
+
+    void drain();
+};
+
+/**
+ * @brief 将区间[begin, end)均分为若干段，在共享线程池上执行
+ *
+ * 调用线程自身执行第一段，全部完成后返回；各段不保证同时运行，段之间不能互相等待
+ *
+ * @param begin 区间起点
+ * @param end 区间终点（不含）
+ * @param body 处理子区间[lo, hi)的函数
+ * @param threads 分段数，不大于0时使用hardware_threads()
+ */
+void parallel_for(int begin, int end, const std::function<void(int, int)>& body, int threads=0);
+
+/**
+ * @brief 将二维区域划分为tile见方的块，在共享线程池上逐块执行
+ *
+ * @param rows 行数
+ * @param cols 列数
+ * @param tile 块边长
+ * @param body 处理块[x0, x1) × [y0, y1)的函数
+ */
+void parallel_tiles(int rows, int cols, int tile, const std::function<void(int, int, int, int)>& body);
+
+/**
+ * @brief 启动threads个同时运行的线程，编号为0到threads - 1
+ *
+ * 只用于需要在线程之间同步（如Barrier）的阶段，这类阶段不能放到线程池中排队执行
+ *
+ * @param threads 线程数
+ * @param body 以线程编号为参数的函数，调用线程执行编号0
+ */
+void parallel_team(int threads, const std::function<void(int)>& body);
+
+/**
+ * @brief 可重复使用的线程屏障
+ */
+class Barrier {
+public:
+    explicit Barrier(int count);
+
+    /**
+     * @brief 阻塞直到全部count个线程都到达
+     */
+    void wait();
+
+private:
+    int count;
+    int waiting;
+    unsigned long generation;
+    std::mutex lock;
+    std::condition_variable ready;
+};
+
+#endif
@@ -1,5 +1,98 @@
 #include "aStar/aStar.hpp"
 
+void SearchSpace::prepare(size_t cells) {
+    if (seen.size() != cells) {
+        cost.assign(cells, 0.0);
+        parent.assign(cells, -1);
+        seen.assign(cells, 0);
+        closed.assign(cells, 0);
+        epoch = 0;
+    }
+    if (++epoch == 0) {
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(closed.begin(), closed.end(), 0);
+        epoch = 1;
+    }
+}
+
+/**
+ * @brief 网格A*的公共核心
+ *
+ * 代价与a_star_search相同；每个格子出队一次后关闭，
+ * 启发式可采纳时第一个出队的终点即代价最小的终点
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标，调用者保证可通行
+ * @param heuristic 到终点的可采纳下界
+ * @param allowed 通行条件，为空时使用graph.edge_allowed
+ * @param is_goal 按格子编号 x * cols + y 判断是否为终点
+ * @param space 工作区
+ * @return 从起点到第一个出队的终点的路径，找不到终点时返回空序列
+ */
+std::vector<Intex> grid_star(const SqPlain& graph, const Intex& start,
+                             const std::function<double(const Intex&)>& heuristic,
+                             const std::function<bool(const Intex&)>& allowed,
+                             const std::function<bool(int)>& is_goal,
+                             SearchSpace& space) {
+
+    int cols = graph.cols();
+    space.prepare(static_cast<size_t>(graph.rows()) * cols);
+    uint32_t epoch = space.epoch;
+    int source = start.x * cols + start.y;
+
+    using que_unit = std::pair<double, int>;
+    std::priority_queue<que_unit, std::vector<que_unit>, std::greater<que_unit>> frontier;
+    space.cost[source] = 0.0;
+    space.parent[source] = -1;
+    space.seen[source] = epoch;
+    frontier.push({heuristic(start), source});
+
+    int reached = -1;
+    while (!frontier.empty()) {
+        int id = frontier.top().second;
+        frontier.pop();
+        if (space.closed[id] == epoch) continue;
+        space.closed[id] = epoch;
+        if (is_goal(id)) {
+            reached = id;
+            break;
+        }
+
+        Intex current(id / cols, id % cols);
+        for (int idx = 0; idx < 4; idx++) {
+            Intex next = graph.get_neighbour(current, idx);
+            if (allowed ? !allowed(next) : !graph.edge_allowed(next)) continue;
+            int next_id = next.x * cols + next.y;
+            if (space.closed[next_id] == epoch) continue;
+            double new_cost = space.cost[id] + graph.cost(current, next);
+            if (space.seen[next_id] != epoch || new_cost < space.cost[next_id]) {
+                space.seen[next_id] = epoch;
+                space.cost[next_id] = new_cost;
+                space.parent[next_id] = id;
+                frontier.push({new_cost + heuristic(next), next_id});
+            }
+        }
+    }
+    if (reached < 0) {
+        return {};
+    }
+
+    std::vector<Intex> path;
+    for (int id = reached; id != -1; id = space.parent[id]) {
+        path.emplace_back(id / cols, id % cols);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<Intex> grid_star(const SqPlain& graph, const Intex& start,
+                             const std::function<double(const Intex&)>& heuristic,
+                             const std::function<bool(const Intex&)>& allowed,
+                             const std::function<bool(int)>& is_goal) {
+    thread_local SearchSpace space;
+    return grid_star(graph, start, heuristic, allowed, is_goal, space);
+}
+
 /**
  * @brief 使用A*算法在二维地图上搜索从起点到终点的最短路径
  * 
@@ -63,6 +156,161 @@ std::vector<Intex> a_star_search(const SqPlain& graph, const Intex& start, const
     return std::move(path);
 }
 
+/**
+ * @brief 在地面上搜索路径，先用连通分量排除不可达的终点
+ * 
+ * 终点被障碍封闭时普通A*会耗尽整个连通区域才返回，这里在常数时间内直接返回
+ * 
+ * @param ground 地面对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> a_star_search(const Ground& ground, const Intex& start, const Intex& goal) {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    return a_star_search(ground.map, start, goal);
+}
+
+/**
+ * @brief 在地面上搜索与障碍保持距离的路径
+ * 
+ * 代价与a_star_search相同，距离最近障碍小于margin的格子视为不可通行，
+ * 每个格子的判断是对距离场的一次查表
+ * 
+ * @param ground 地面对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param margin 路径上每个格子到最近障碍的最小距离
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> a_star_search(const Ground& ground, const Intex& start, const Intex& goal, double margin) {
+
+    const SqPlain& graph = ground.map;
+    const Clearance& room = ground.clearance();
+    if (!ground.reachable(start, goal) || !room.clear(start, margin) || !room.clear(goal, margin)) {
+        return {};
+    }
+    int target = goal.x * graph.cols() + goal.y;
+    return grid_star(graph, start,
+                     [&](const Intex& at) { return manhattan_distance(at, goal); },
+                     [&](const Intex& at) { return ground.edge_allowed(at) && room.clear(at, margin); },
+                     [target](int id) { return id == target; });
+}
+
+/**
+ * @brief 搜索到一组终点中代价最小者的路径
+ * 
+ * 启发式取到各终点曼哈顿距离的最小值，终点较多时改用到终点包围盒的曼哈顿距离，
+ * 两者都不超过真实代价；第一个出队的终点即代价最小的终点，一次搜索代替K次
+ * 
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goals 候选终点
+ * @return 到最先确定的终点的路径，path.back()即该终点，全部不可达时返回空序列
+ */
+std::vector<Intex> nearest_star(const SqPlain& graph, const Intex& start, const std::vector<Intex>& goals) {
+
+    if (!graph.edge_allowed(start)) {
+        return {};
+    }
+    int cols = graph.cols();
+    std::unordered_set<int> targets;
+    std::vector<Intex> kept;
+    int x0 = graph.rows(), x1 = -1, y0 = cols, y1 = -1;
+    for (const auto& goal : goals) {
+        if (!graph.edge_allowed(goal) || !targets.insert(goal.x * cols + goal.y).second) continue;
+        kept.push_back(goal);
+        x0 = std::min(x0, goal.x);
+        x1 = std::max(x1, goal.x);
+        y0 = std::min(y0, goal.y);
+        y1 = std::max(y1, goal.y);
+    }
+    if (kept.empty()) {
+        return {};
+    }
+
+    const size_t exact_limit = 32;
+    auto heuristic = [&](const Intex& at) {
+        if (kept.size() <= exact_limit) {
+            double best = std::numeric_limits<double>::infinity();
+            for (const auto& goal : kept) {
+                best = std::min(best, manhattan_distance(at, goal));
+            }
+            return best;
+        }
+        int dx = std::max({x0 - at.x, 0, at.x - x1});
+        int dy = std::max({y0 - at.y, 0, at.y - y1});
+        return static_cast<double>(dx + dy);
+    };
+
+    return grid_star(graph, start, heuristic, nullptr, [&targets](int id) { return targets.count(id) > 0; });
+}
+
+std::vector<Intex> nearest_star(const Ground& ground, const Intex& start, const std::vector<Intex>& goals) {
+    std::vector<Intex> kept;
+    for (const auto& goal : goals) {
+        if (ground.reachable(start, goal)) {
+            kept.push_back(goal);
+        }
+    }
+    if (kept.empty()) {
+        return {};
+    }
+    return nearest_star(ground.map, start, kept);
+}
+
+/**
+ * @brief 单源最短路径，返回到所有格子的代价
+ * 
+ * 以格子编号 x * cols + y 为下标的稠密Dijkstra，代价与a_star_search一致，
+ * 用于地标表、代价场等需要完整距离表的预处理
+ * 
+ * @param graph 二维地图对象
+ * @param source 源点坐标
+ * @return 到每个格子的最短代价，不可达格子为无穷大
+ */
+std::vector<double> dijkstra(const SqPlain& graph, const Intex& source) {
+
+    if (graph.empty()) {
+        return {};
+    }
+    int rows = graph.rows();
+    int cols = graph.cols();
+    std::vector<double> distance(static_cast<size_t>(rows) * cols, std::numeric_limits<double>::infinity());
+    if (!graph.edge_allowed(source)) {
+        return distance;
+    }
+
+    using que_unit = std::pair<double, int>;
+    auto cmp = [](const que_unit& a, const que_unit& b) {
+        return a.first > b.first;
+    };
+    std::priority_queue<que_unit, std::vector<que_unit>, decltype(cmp)> frontier(cmp);
+    distance[source.x * cols + source.y] = 0.0;
+    frontier.push({0.0, source.x * cols + source.y});
+
+    while (!frontier.empty()) {
+        auto top = frontier.top();
+        frontier.pop();
+        if (top.first > distance[top.second]) continue;
+
+        Intex current(top.second / cols, top.second % cols);
+        for (int idx = 0; idx < 4; idx++) {
+            Intex next = graph.get_neighbour(current, idx);
+            if (!graph.edge_allowed(next)) continue;
+            int id = next.x * cols + next.y;
+            double new_cost = top.first + graph.cost(current, next);
+            if (new_cost < distance[id]) {
+                distance[id] = new_cost;
+                frontier.push({new_cost, id});
+            }
+        }
+    }
+    return distance;
+}
+
 /**
  * @brief 使用缩放地图的A*算法进行路径规划
  * 
@@ -129,6 +377,13 @@ std::vector<Intex> scale_star(const SqPlain& graph, const Intex& start, const In
     return guides;
 }
 
+std::vector<Intex> scale_star(const Ground& ground, const Intex& start, const Intex& goal, const double& scale) {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    return scale_star(ground.map, start, goal, scale);
+}
+
 // std::vector<SqDot> scale_star(const SqPlain& graph, const SqDot& start, const SqDot& goal, const double& scale) {
 
 //     auto ss = start.scale(scale);
@@ -0,0 +1,314 @@
+#include "aStar/corridor.hpp"
+
+Corridor::Corridor(): first_row(0), row_start{0}, total(0) {}
+
+/**
+ * @brief 构造函数，以引导折线为中心线生成走廊
+ *
+ * 沿每段折线逐格前进，把每个经过点周围 (2 * radius + 1) 见方的区域登记为所在行的列区间，
+ * 再按行排序合并，走廊的大小与折线长度乘半宽成正比，与地图面积无关
+ *
+ * @param graph 二维地图对象
+ * @param guides 引导点序列
+ * @param radius 走廊半宽（切比雪夫距离）
+ */
+Corridor::Corridor(const SqPlain& graph, const std::vector<Intex>& guides, int radius): first_row(0), row_start{0}, total(0) {
+
+    if (graph.empty() || guides.empty()) {
+        return;
+    }
+    radius = std::max(radius, 0);
+    int rows = graph.rows();
+    int cols = graph.cols();
+
+    int low = rows;
+    int high = -1;
+    for (const auto& guide : guides) {
+        low = std::min(low, guide.x - radius);
+        high = std::max(high, guide.x + radius);
+    }
+    low = std::max(low, 0);
+    high = std::min(high, rows - 1);
+    if (low > high) {
+        return;
+    }
+
+    std::vector<std::vector<std::pair<int, int>>> pending(high - low + 1);
+    auto stamp = [&](int x, int y) {
+        int y0 = std::max(y - radius, 0);
+        int y1 = std::min(y + radius, cols - 1);
+        if (y0 > y1) {
+            return;
+        }
+        for (int row = std::max(x - radius, low); row <= std::min(x + radius, high); row++) {
+            pending[row - low].emplace_back(y0, y1);
+        }
+    };
+
+    stamp(guides[0].x, guides[0].y);
+    for (size_t i = 1; i < guides.size(); i++) {
+        const Intex& from = guides[i - 1];
+        const Intex& to = guides[i];
+        int steps = std::max(std::abs(to.x - from.x), std::abs(to.y - from.y));
+        for (int k = 1; k <= steps; k++) {
+            int x = from.x + static_cast<int>(std::lround(static_cast<double>(to.x - from.x) * k / steps));
+            int y = from.y + static_cast<int>(std::lround(static_cast<double>(to.y - from.y) * k / steps));
+            stamp(x, y);
+        }
+    }
+
+    first_row = low;
+    row_start.assign(1, 0);
+    for (auto& intervals : pending) {
+        std::sort(intervals.begin(), intervals.end());
+        size_t begin = spans.size();
+        for (const auto& interval : intervals) {
+            if (spans.size() > begin && interval.first <= spans.back().y1 + 1) {
+                if (interval.second > spans.back().y1) {
+                    total += interval.second - spans.back().y1;
+                    spans.back().y1 = interval.second;
+                }
+            } else {
+                spans.push_back({interval.first, interval.second, total});
+                total += interval.second - interval.first + 1;
+            }
+        }
+        row_start.push_back(static_cast<int>(spans.size()));
+    }
+}
+
+int Corridor::index(const Intex& at) const {
+    int row = at.x - first_row;
+    if (row < 0 || row + 1 >= static_cast<int>(row_start.size())) {
+        return -1;
+    }
+    auto begin = spans.begin() + row_start[row];
+    auto end = spans.begin() + row_start[row + 1];
+    auto found = std::upper_bound(begin, end, at.y, [](int y, const Span& span) {
+        return y < span.y0;
+    });
+    if (found == begin) {
+        return -1;
+    }
+    --found;
+    if (at.y > found->y1) {
+        return -1;
+    }
+    return found->offset + at.y - found->y0;
+}
+
+Intex Corridor::cell(int index) const {
+    if (index < 0 || index >= total) {
+        return Intex(-1, -1);
+    }
+    auto found = std::upper_bound(spans.begin(), spans.end(), index, [](int value, const Span& span) {
+        return value < span.offset;
+    });
+    --found;
+    int position = static_cast<int>(found - spans.begin());
+    int row = static_cast<int>(std::upper_bound(row_start.begin(), row_start.end(), position) - row_start.begin()) - 1;
+    return Intex(first_row + row, found->y0 + index - found->offset);
+}
+
+bool Corridor::contains(const Intex& at) const {
+    return index(at) >= 0;
+}
+
+int Corridor::size() const {
+    return total;
+}
+
+bool Corridor::empty() const {
+    return total == 0;
+}
+
+/**
+ * @brief 只在走廊内搜索的A*
+ *
+ * 代价、启发式与a_star_search相同，所有工作数组按走廊的局部下标分配
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param corridor 搜索走廊
+ * @return 从起点到终点的路径点序列，走廊内不连通时返回空序列
+ */
+std::vector<Intex> corridor_star(const SqPlain& graph, const Intex& start, const Intex& goal, const Corridor& corridor) {
+
+    int source = corridor.index(start);
+    int target = corridor.index(goal);
+    if (source < 0 || target < 0 || !graph.edge_allowed(start) || !graph.edge_allowed(goal)) {
+        return {};
+    }
+
+    std::vector<double> cost_so_far(corridor.size(), std::numeric_limits<double>::infinity());
+    std::vector<int> came_from(corridor.size(), -1);
+    std::vector<char> closed(corridor.size(), 0);
+
+    using que_unit = std::pair<double, int>;
+    std::priority_queue<que_unit, std::vector<que_unit>, std::greater<que_unit>> frontier;
+    cost_so_far[source] = 0.0;
+    frontier.push({manhattan_distance(start, goal), source});
+    while (!frontier.empty()) {
+        int current = frontier.top().second;
+        frontier.pop();
+        if (closed[current]) continue;
+        closed[current] = 1;
+        if (current == target) break;
+
+        Intex at = corridor.cell(current);
+        for (int idx = 0; idx < 4; idx++) {
+            Intex next = graph.get_neighbour(at, idx);
+            int local = corridor.index(next);
+            if (local < 0 || closed[local] || !graph.edge_allowed(next)) continue;
+            double new_cost = cost_so_far[current] + graph.cost(at, next);
+            if (new_cost < cost_so_far[local]) {
+                cost_so_far[local] = new_cost;
+                came_from[local] = current;
+                frontier.push({new_cost + manhattan_distance(next, goal), local});
+            }
+        }
+    }
+    if (!closed[target]) {
+        return {};
+    }
+
+    std::vector<Intex> path;
+    for (int current = target; current != -1; current = came_from[current]) {
+        path.push_back(corridor.cell(current));
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/**
+ * @brief 先用scale_star求粗略引导点，再在引导折线周围的走廊内细化为全分辨率路径
+ *
+ * 走廊内不连通时将半宽加倍重试两次，仍失败时退回全图搜索
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param scale 缩放比例
+ * @param radius 走廊半宽
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> refine_star(const SqPlain& graph, const Intex& start, const Intex& goal, const double& scale, int radius) {
+
+    if (!graph.edge_allowed(start) || !graph.edge_allowed(goal)) {
+        return {};
+    }
+    auto guides = scale_star(graph, start, goal, scale);
+    radius = std::max(radius, 1);
+    for (int attempt = 0; attempt < 3; attempt++, radius *= 2) {
+        auto path = corridor_star(graph, start, goal, Corridor(graph, guides, radius));
+        if (!path.empty()) {
+            return path;
+        }
+    }
+    auto path = a_star_search(graph, start, goal);
+    if (path.empty() || path.front() != start || path.back() != goal) {
+        return {};
+    }
+    return path;
+}
+
+std::vector<Intex> refine_star(const Ground& ground, const Intex& start, const Intex& goal, const double& scale, int radius) {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    return refine_star(ground.map, start, goal, scale, radius);
+}
+
+/**
+ * @brief 把落在障碍上的引导点移到附近的可通行格子
+ *
+ * 按切比雪夫距离由近到远逐圈查找，同一圈内按行、列顺序取第一个
+ *
+ * @return 找不到时返回(-1, -1)
+ */
+static Intex snap(const SqPlain& graph, const Intex& guide, int reach) {
+    for (int ring = 0; ring <= reach; ring++) {
+        for (int x = guide.x - ring; x <= guide.x + ring; x++) {
+            for (int y = guide.y - ring; y <= guide.y + ring; y++) {
+                if (std::max(std::abs(x - guide.x), std::abs(y - guide.y)) != ring) continue;
+                if (graph.edge_allowed(Intex(x, y))) {
+                    return Intex(x, y);
+                }
+            }
+        }
+    }
+    return Intex(-1, -1);
+}
+
+/**
+ * @brief 分段并行细化：相邻引导点之间各自在局部走廊内搜索，再按顺序拼接
+ *
+ * 每段的搜索只依赖两端的引导点，线程从共享计数器领取下一段，结果按段号存放，
+ * 因此输出与线程数和调度顺序无关；某段在加倍半宽后仍不连通时整体退回refine_star
+ *
+ * @param graph 二维地图对象
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @param scale 缩放比例
+ * @param radius 每段走廊的半宽
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ * @return 从起点到终点的路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> segment_star(const SqPlain& graph, const Intex& start, const Intex& goal, const double& scale, int radius, int threads) {
+
+    if (!graph.edge_allowed(start) || !graph.edge_allowed(goal)) {
+        return {};
+    }
+    radius = std::max(radius, 1);
+    auto guides = scale_star(graph, start, goal, scale);
+
+    std::vector<Intex> stops{start};
+    for (size_t i = 1; i + 1 < guides.size(); i++) {
+        Intex stop = snap(graph, guides[i], radius);
+        if (stop != Intex(-1, -1) && stop != stops.back()) {
+            stops.push_back(stop);
+        }
+    }
+    if (stops.back() != goal) {
+        stops.push_back(goal);
+    }
+    if (stops.size() == 1) {
+        return {start};
+    }
+
+    int count = static_cast<int>(stops.size()) - 1;
+    std::vector<std::vector<Intex>> pieces(count);
+    std::atomic<int> next(0);
+    std::atomic<bool> failed(false);
+    if (threads <= 0) {
+        threads = hardware_threads();
+    }
+    parallel_for(0, std::min(threads, count), [&](int, int) {
+        for (int piece = next++; piece < count && !failed; piece = next++) {
+            int width = radius;
+            for (int attempt = 0; attempt < 3 && pieces[piece].empty(); attempt++, width *= 2) {
+                pieces[piece] = corridor_star(graph, stops[piece], stops[piece + 1], Corridor(graph, {stops[piece], stops[piece + 1]}, width));
+            }
+            if (pieces[piece].empty()) {
+                failed = true;
+            }
+        }
+    }, threads);
+    if (failed) {
+        return refine_star(graph, start, goal, scale, radius);
+    }
+
+    std::vector<Intex> path{start};
+    for (const auto& piece : pieces) {
+        path.insert(path.end(), piece.begin() + 1, piece.end());
+    }
+    return path;
+}
+
+std::vector<Intex> segment_star(const Ground& ground, const Intex& start, const Intex& goal, const double& scale, int radius, int threads) {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    return segment_star(ground.map, start, goal, scale, radius, threads);
+}
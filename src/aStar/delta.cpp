@@ -0,0 +1,135 @@
+#include "aStar/delta.hpp"
+
+/**
+ * @brief 每个条带包含的行数，条带按轮转方式分给线程，使波前始终覆盖多个线程
+ */
+static const int strip_rows = 16;
+
+/**
+ * @brief 松弛请求
+ */
+struct Relax {
+    int id;
+    double cost;
+};
+
+/**
+ * @brief 并行delta-stepping单源最短路径
+ *
+ * 每一轮分三步：各线程展开自己在当前桶中的格子并按目标格子的归属投递松弛请求；
+ * 各线程处理投递给自己的请求并放入对应的桶；汇总所有线程最小的非空桶编号，
+ * 当前桶仍有格子时重复该桶，否则跳到下一个非空桶。
+ * 收件箱与桶编号的读写都被两次屏障隔开，下一轮写入前所有线程已读完本轮结果。
+ * 格子在距离变小后会重新入桶，已按同一距离展开过的格子不会重复展开
+ *
+ * @param graph 二维地图对象
+ * @param source 源点坐标
+ * @param delta 桶宽度，不大于0时取最小单步代价
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ * @return 按 x * cols + y 排列的代价表，不可达格子为无穷大
+ */
+std::vector<double> delta_stepping(const SqPlain& graph, const Intex& source, double delta, int threads) {
+
+    if (graph.empty()) {
+        return {};
+    }
+    int rows = graph.rows();
+    int cols = graph.cols();
+    size_t size = static_cast<size_t>(rows) * cols;
+    std::vector<double> distance(size, std::numeric_limits<double>::infinity());
+    if (!graph.edge_allowed(source)) {
+        return distance;
+    }
+
+    if (threads <= 0) {
+        threads = hardware_threads();
+    }
+    threads = std::max(1, std::min(threads, (rows + strip_rows - 1) / strip_rows));
+    if (delta <= 0.0) {
+        // 进入格子的单步代价为 1 + h，只统计可通行格子，set_unit标记的负高度障碍不参与
+        double lowest = std::numeric_limits<double>::infinity();
+        for (int x = 0; x < rows; x++) {
+            for (int y = 0; y < cols; y++) {
+                if (graph.edge_allowed(Intex(x, y))) {
+                    lowest = std::min(lowest, graph[x][y]);
+                }
+            }
+        }
+        delta = 1.0 + lowest;
+    }
+
+    auto owner = [&](int id) {
+        return (id / cols / strip_rows) % threads;
+    };
+    auto bucket_of = [&](double cost) {
+        return static_cast<size_t>(cost / delta);
+    };
+
+    std::vector<std::vector<std::vector<int>>> buckets(threads);
+    std::vector<std::vector<std::vector<Relax>>> outbox(threads, std::vector<std::vector<Relax>>(threads));
+    std::vector<double> expanded(size, std::numeric_limits<double>::infinity());
+    std::vector<size_t> next_bucket(threads);
+    const size_t none = std::numeric_limits<size_t>::max();
+    Barrier barrier(threads);
+
+    int source_id = source.x * cols + source.y;
+    distance[source_id] = 0.0;
+    buckets[owner(source_id)].resize(1);
+    buckets[owner(source_id)][0].push_back(source_id);
+
+    // 每轮之间用屏障同步，各线程必须同时运行，不能放到线程池中排队
+    parallel_team(threads, [&](int t) {
+        auto& mine = buckets[t];
+        size_t current = 0;
+        std::vector<int> frontier;
+        while (true) {
+            frontier.clear();
+            if (current < mine.size()) {
+                frontier.swap(mine[current]);
+            }
+            for (int id : frontier) {
+                double base = distance[id];
+                if (base >= expanded[id]) continue;
+                expanded[id] = base;
+
+                Intex at(id / cols, id % cols);
+                for (int idx = 0; idx < 4; idx++) {
+                    Intex next = graph.get_neighbour(at, idx);
+                    if (!graph.edge_allowed(next)) continue;
+                    int next_id = next.x * cols + next.y;
+                    outbox[t][owner(next_id)].push_back({next_id, base + graph.cost(at, next)});
+                }
+            }
+            barrier.wait();
+
+            for (int s = 0; s < threads; s++) {
+                for (const auto& relax : outbox[s][t]) {
+                    if (relax.cost >= distance[relax.id]) continue;
+                    distance[relax.id] = relax.cost;
+                    size_t index = bucket_of(relax.cost);
+                    if (index >= mine.size()) {
+                        mine.resize(index + 1);
+                    }
+                    mine[index].push_back(relax.id);
+                }
+                outbox[s][t].clear();
+            }
+
+            size_t local = none;
+            for (size_t index = current; index < mine.size(); index++) {
+                if (!mine[index].empty()) {
+                    local = index;
+                    break;
+                }
+            }
+            next_bucket[t] = local;
+            barrier.wait();
+
+            current = *std::min_element(next_bucket.begin(), next_bucket.end());
+            if (current == none) {
+                break;
+            }
+        }
+    });
+    return distance;
+}
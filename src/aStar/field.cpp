@@ -0,0 +1,196 @@
+#include "aStar/field.hpp"
+
+CostField::CostField(): goal(-1, -1), row_count(0), col_count(0) {}
+
+/**
+ * @brief 构造函数，计算全图到终点的代价
+ *
+ * 单步代价为 1 + h(to)，路径反向后代价变为 d(v, g) = d(g, v) + h(g) - h(v)，
+ * 因此只需从终点做一次单源最短路径即可得到全图到终点的代价
+ *
+ * @param graph 二维地图对象
+ * @param goal 终点坐标
+ */
+CostField::CostField(const SqPlain& graph, const Intex& goal): goal(goal), row_count(0), col_count(0) {
+
+    if (graph.empty() || !graph.edge_allowed(goal)) {
+        return;
+    }
+    row_count = graph.rows();
+    col_count = graph.cols();
+    togo = delta_stepping(graph, goal);
+
+    double lift = graph[goal.x][goal.y];
+    for (int x = 0; x < row_count; x++) {
+        for (int y = 0; y < col_count; y++) {
+            double& value = togo[static_cast<size_t>(x) * col_count + y];
+            if (value != std::numeric_limits<double>::infinity()) {
+                value += lift - graph[x][y];
+            }
+        }
+    }
+}
+
+double CostField::cost(const Intex& at) const {
+    if (at.x < 0 || at.x >= row_count || at.y < 0 || at.y >= col_count) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return togo[static_cast<size_t>(at.x) * col_count + at.y];
+}
+
+double CostField::heuristic(const Intex& at) const {
+    return cost(at);
+}
+
+/**
+ * @brief 沿代价场下降得到从start到终点的路径
+ *
+ * 每一步选择使 单步代价 + 剩余代价 最小的邻居，单步代价为正，剩余代价严格下降，
+ * 因此不会成环，复杂度与路径长度成正比
+ *
+ * @param graph 构建代价场时使用的地图
+ * @param start 起点坐标
+ * @return 路径点序列，不可达时返回空序列
+ */
+std::vector<Intex> CostField::descend(const SqPlain& graph, const Intex& start) const {
+    if (cost(start) == std::numeric_limits<double>::infinity()) {
+        return {};
+    }
+
+    std::vector<Intex> path{start};
+    Intex current = start;
+    size_t max_steps = togo.size();
+    while (current != goal && path.size() <= max_steps) {
+        Intex best(-1, -1);
+        double best_cost = std::numeric_limits<double>::infinity();
+        for (int idx = 0; idx < 4; idx++) {
+            Intex next = graph.get_neighbour(current, idx);
+            double remain = cost(next);
+            if (remain == std::numeric_limits<double>::infinity()) continue;
+            double total = graph.cost(current, next) + remain;
+            if (total < best_cost) {
+                best_cost = total;
+                best = next;
+            }
+        }
+        if (best == Intex(-1, -1)) {
+            return {};
+        }
+        current = best;
+        path.push_back(current);
+    }
+    if (current != goal) {
+        return {};
+    }
+    return path;
+}
+
+size_t CostField::bytes() const {
+    return sizeof(CostField) + togo.capacity() * sizeof(double);
+}
+
+bool CostField::empty() const {
+    return togo.empty();
+}
+
+bool FieldCache::Key::operator==(const Key& other) const {
+    return graph == other.graph && rows == other.rows && cols == other.cols && owner == other.owner &&
+           x == other.x && y == other.y && version == other.version;
+}
+
+size_t FieldCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = std::hash<const SqPlain*>()(key.graph);
+    seed ^= std::hash<uint64_t>()(key.owner) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<int>()(key.x) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<int>()(key.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<uint64_t>()(key.version) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+FieldCache::FieldCache(size_t budget): budget(budget), used(0) {}
+
+/**
+ * @brief 获取代价场，不存在时计算并缓存
+ *
+ * 地图按地址与形状区分；地图被销毁后在同一地址重建时，调用者需要递增版本或调用clear，
+ * 通过Ground使用缓存时由地面编号区分，没有这一限制
+ *
+ * @param graph 二维地图对象
+ * @param goal 终点坐标
+ * @param version 地图版本，地图修改后应递增
+ * @return 代价场
+ */
+std::shared_ptr<const CostField> FieldCache::get(const SqPlain& graph, const Intex& goal, uint64_t version) {
+    return fetch(graph, Key{&graph, graph.rows(), graph.cols(), 0, goal.x, goal.y, version});
+}
+
+std::shared_ptr<const CostField> FieldCache::get(const Ground& ground, const Intex& goal) {
+    const SqPlain& graph = ground.map;
+    return fetch(graph, Key{&graph, graph.rows(), graph.cols(), ground.id(), goal.x, goal.y, ground.version()});
+}
+
+/**
+ * @brief 按键查找代价场，不存在时计算并缓存
+ *
+ * 计算在锁外进行，多个线程同时请求同一代价场时可能重复计算，只保留先写入的结果；
+ * 返回共享指针，被淘汰的代价场在使用者释放前仍然有效
+ */
+std::shared_ptr<const CostField> FieldCache::fetch(const SqPlain& graph, const Key& key) {
+    Intex goal(key.x, key.y);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = index.find(key);
+        if (found != index.end()) {
+            order.splice(order.begin(), order, found->second);
+            return found->second->second;
+        }
+    }
+
+    auto field = std::make_shared<const CostField>(graph, goal);
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = index.find(key);
+    if (found != index.end()) {
+        order.splice(order.begin(), order, found->second);
+        return found->second->second;
+    }
+    order.emplace_front(key, field);
+    index[key] = order.begin();
+    used += field->bytes();
+
+    // 至少保留刚写入的代价场
+    while (used > budget && order.size() > 1) {
+        used -= order.back().second->bytes();
+        index.erase(order.back().first);
+        order.pop_back();
+    }
+    return field;
+}
+
+std::vector<Intex> FieldCache::path(const SqPlain& graph, const Intex& start, const Intex& goal, uint64_t version) {
+    return get(graph, goal, version)->descend(graph, start);
+}
+
+std::vector<Intex> FieldCache::path(const Ground& ground, const Intex& start, const Intex& goal) {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    return get(ground, goal)->descend(ground.map, start);
+}
+
+size_t FieldCache::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return order.size();
+}
+
+size_t FieldCache::bytes() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return used;
+}
+
+void FieldCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    order.clear();
+    index.clear();
+    used = 0;
+}
@@ -0,0 +1,598 @@
+#include "aStar/hierarchy.hpp"
+
+/**
+ * @brief 索引文件头部标识
+ */
+static const char hierarchy_magic[8] = {'A', 'S', 'T', 'A', 'R', 'C', 'H', '2'};
+
+/**
+ * @brief 见证搜索的最大出队次数，超过后视为没有见证路径
+ */
+static const int witness_settle_limit = 500;
+
+/**
+ * @brief 收缩过程中使用的工作图
+ */
+struct Contraction {
+    std::vector<std::vector<Arc>> adj;
+    std::vector<bool> contracted;
+    std::vector<int> removed;
+    std::vector<int> depth;
+    std::vector<double> dist;
+    std::vector<int> touched;
+    std::vector<bool> wanted;
+
+    explicit Contraction(size_t size):
+        adj(size), contracted(size, false), removed(size, 0), depth(size, 0),
+        dist(size, std::numeric_limits<double>::infinity()), wanted(size, false) {}
+
+    /**
+     * @brief 在未收缩的格子上进行有界的Dijkstra，不经过avoid
+     *
+     * @param source 起点编号
+     * @param avoid 需要绕开的格子编号
+     * @param limit 距离上界，超过后停止
+     * @param remaining 尚未出队的目标数，全部出队后提前停止
+     */
+    void witness(int source, int avoid, double limit, int remaining) {
+        for (int id : touched) {
+            dist[id] = std::numeric_limits<double>::infinity();
+        }
+        touched.clear();
+
+        using que_unit = std::pair<double, int>;
+        auto cmp = [](const que_unit& a, const que_unit& b) {
+            return a.first > b.first;
+        };
+        std::priority_queue<que_unit, std::vector<que_unit>, decltype(cmp)> frontier(cmp);
+        dist[source] = 0.0;
+        touched.push_back(source);
+        frontier.push({0.0, source});
+
+        int settled = 0;
+        while (!frontier.empty()) {
+            auto top = frontier.top();
+            frontier.pop();
+            if (top.first > dist[top.second]) continue;
+            if (top.first > limit || ++settled > witness_settle_limit) break;
+            if (wanted[top.second] && --remaining == 0) break;
+
+            for (const auto& arc : adj[top.second]) {
+                if (arc.to == avoid || contracted[arc.to]) continue;
+                double new_cost = top.first + arc.weight;
+                if (new_cost < dist[arc.to]) {
+                    if (dist[arc.to] == std::numeric_limits<double>::infinity()) {
+                        touched.push_back(arc.to);
+                    }
+                    dist[arc.to] = new_cost;
+                    frontier.push({new_cost, arc.to});
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief 插入或缩短一条无向边
+     */
+    void connect(int a, int b, double weight, int middle) {
+        for (int side = 0; side < 2; side++) {
+            auto& list = adj[side == 0 ? a : b];
+            int other = side == 0 ? b : a;
+            auto found = std::find_if(list.begin(), list.end(), [&](const Arc& arc) {
+                return arc.to == other;
+            });
+            if (found == list.end()) {
+                list.push_back({other, weight, middle});
+            } else if (weight < found->weight) {
+                found->weight = weight;
+                found->middle = middle;
+            }
+        }
+    }
+
+    /**
+     * @brief 收缩一个格子，或仅统计收缩需要的捷径数
+     *
+     * @param v 格子编号
+     * @param simulate 为true时只计数不修改图
+     * @return 需要添加的捷径数
+     */
+    int contract(int v, bool simulate) {
+        const std::vector<Arc> around = adj[v];
+        int added = 0;
+        for (size_t i = 0; i + 1 < around.size(); i++) {
+            double limit = 0.0;
+            for (size_t j = i + 1; j < around.size(); j++) {
+                limit = std::max(limit, around[i].weight + around[j].weight);
+            }
+            for (size_t j = i + 1; j < around.size(); j++) {
+                wanted[around[j].to] = true;
+            }
+            witness(around[i].to, v, limit, static_cast<int>(around.size() - i - 1));
+            for (size_t j = i + 1; j < around.size(); j++) {
+                wanted[around[j].to] = false;
+            }
+            for (size_t j = i + 1; j < around.size(); j++) {
+                double through = around[i].weight + around[j].weight;
+                if (dist[around[j].to] <= through) continue;
+                added++;
+                if (!simulate) {
+                    connect(around[i].to, around[j].to, through, v);
+                }
+            }
+        }
+        return added;
+    }
+
+    /**
+     * @brief 收缩优先级：边差加上已收缩邻居数
+     */
+    int priority(int v) {
+        return 2 * (contract(v, true) - static_cast<int>(adj[v].size())) + removed[v] + depth[v];
+    }
+};
+
+/**
+ * @brief 查询使用的稠密工作区，按轮次标记代替逐次清空，每个线程各持有一份
+ */
+struct Workspace {
+    using que_unit = std::pair<double, int>;
+    using que_type = std::priority_queue<que_unit, std::vector<que_unit>, std::greater<que_unit>>;
+
+    std::vector<uint32_t> stamp[2];
+    std::vector<double> cost[2];
+    std::vector<int> parent[2];
+    que_type frontier[2];
+    uint32_t round = 0;
+
+    void reset(size_t size) {
+        for (int side = 0; side < 2; side++) {
+            if (stamp[side].size() != size) {
+                stamp[side].assign(size, 0);
+                cost[side].resize(size);
+                parent[side].resize(size);
+                round = 0;
+            }
+            frontier[side] = que_type();
+        }
+        if (++round == 0) {
+            std::fill(stamp[0].begin(), stamp[0].end(), 0);
+            std::fill(stamp[1].begin(), stamp[1].end(), 0);
+            round = 1;
+        }
+    }
+};
+
+Hierarchy::Hierarchy(): row_count(0), col_count(0) {}
+
+/**
+ * @brief 构造函数，对地图进行收缩预处理
+ *
+ * 单步代价 1 + h(to) 与方向有关，这里改用对称边权 1 + (h(u) + h(v)) / 2：
+ * 任意路径两种代价之差只取决于起终点高度，最短路径不变，
+ * 因此可以构建无向的收缩层次，向上图同时服务正向与反向搜索。
+ * 收缩次序按边差惰性更新，见证搜索有出队次数上限，找不到见证时保守地添加捷径
+ *
+ * @param graph 二维地图对象
+ */
+Hierarchy::Hierarchy(const SqPlain& graph): row_count(0), col_count(0) {
+
+    if (graph.empty()) {
+        return;
+    }
+    row_count = graph.rows();
+    col_count = graph.cols();
+    size_t size = static_cast<size_t>(row_count) * col_count;
+    rank.assign(size, -1);
+    height.assign(size, 0.0);
+
+    Contraction work(size);
+    std::vector<int> passable;
+    for (int x = 0; x < row_count; x++) {
+        for (int y = 0; y < col_count; y++) {
+            Intex current(x, y);
+            if (!graph.edge_allowed(current)) continue;
+            int id = x * col_count + y;
+            height[id] = graph[x][y];
+            passable.push_back(id);
+            for (int idx = 0; idx < 2; idx++) {
+                Intex next = graph.get_neighbour(current, idx == 0 ? 1 : 3);
+                if (!graph.edge_allowed(next)) continue;
+                work.connect(id, next.x * col_count + next.y, 1.0 + (graph[x][y] + graph[next.x][next.y]) / 2.0, -1);
+            }
+        }
+    }
+
+    using que_unit = std::pair<int, int>;
+    std::priority_queue<que_unit, std::vector<que_unit>, std::greater<que_unit>> order;
+    std::vector<int> current_priority(size, 0);
+    for (int id : passable) {
+        current_priority[id] = work.priority(id);
+        order.push({current_priority[id], id});
+    }
+
+    std::vector<std::vector<Arc>> upward(size);
+    int level = 0;
+    while (!order.empty()) {
+        auto top = order.top();
+        order.pop();
+        int v = top.second;
+        if (work.contracted[v] || top.first != current_priority[v]) continue;
+
+        int fresh = work.priority(v);
+        if (!order.empty() && fresh > order.top().first) {
+            current_priority[v] = fresh;
+            order.push({fresh, v});
+            continue;
+        }
+
+        work.contract(v, false);
+        work.contracted[v] = true;
+        rank[v] = level++;
+        for (const auto& arc : work.adj[v]) {
+            auto& list = work.adj[arc.to];
+            list.erase(std::remove_if(list.begin(), list.end(), [&](const Arc& other) {
+                return other.to == v;
+            }), list.end());
+            work.removed[arc.to]++;
+            work.depth[arc.to] = std::max(work.depth[arc.to], work.depth[v] + 1);
+        }
+        upward[v] = std::move(work.adj[v]);
+        work.adj[v].clear();
+    }
+
+    up_start.assign(size + 1, 0);
+    for (size_t id = 0; id < size; id++) {
+        up_arcs.insert(up_arcs.end(), upward[id].begin(), upward[id].end());
+        up_start[id + 1] = static_cast<int>(up_arcs.size());
+    }
+}
+
+/**
+ * @brief 在向上图中进行双向搜索
+ *
+ * 两个方向交替扩展，某一方向的队首已不小于当前最优值时该方向停止
+ *
+ * @param source 起点编号
+ * @param target 终点编号
+ * @param chain 输出从起点经过最高点到终点的向上图格子序列
+ * @param best 输出对称边权下的最短代价
+ * @return 可达返回true
+ */
+bool Hierarchy::meet(int source, int target, std::vector<int>& chain, double& best) const {
+    thread_local Workspace space;
+    space.reset(rank.size());
+    auto cost_of = [&](int side, int id) {
+        return space.stamp[side][id] == space.round ? space.cost[side][id] : std::numeric_limits<double>::infinity();
+    };
+    auto reach = [&](int side, int id, double cost, int parent) {
+        space.stamp[side][id] = space.round;
+        space.cost[side][id] = cost;
+        space.parent[side][id] = parent;
+        space.frontier[side].push({cost, id});
+    };
+    reach(0, source, 0.0, source);
+    reach(1, target, 0.0, target);
+
+    best = std::numeric_limits<double>::infinity();
+    int middle = -1;
+    int side = 0;
+    bool done[2] = {false, false};
+    while (!done[0] || !done[1]) {
+        auto& frontier = space.frontier[side];
+        if (!done[side] && (frontier.empty() || frontier.top().first >= best)) {
+            done[side] = true;
+        }
+        if (done[side]) {
+            side ^= 1;
+            continue;
+        }
+        auto top = frontier.top();
+        frontier.pop();
+        int id = top.second;
+        if (top.first > space.cost[side][id]) {
+            side ^= 1;
+            continue;
+        }
+
+        // 若某个更高次序的已到达格子能以更小代价到达id，则id不在最短的上行路径上
+        bool stalled = false;
+        for (int k = up_start[id]; k < up_start[id + 1] && !stalled; k++) {
+            stalled = cost_of(side, up_arcs[k].to) + up_arcs[k].weight < top.first;
+        }
+        if (stalled) {
+            side ^= 1;
+            continue;
+        }
+
+        double other = cost_of(side ^ 1, id);
+        if (top.first + other < best) {
+            best = top.first + other;
+            middle = id;
+        }
+
+        for (int k = up_start[id]; k < up_start[id + 1]; k++) {
+            const auto& arc = up_arcs[k];
+            double new_cost = top.first + arc.weight;
+            if (new_cost < cost_of(side, arc.to)) {
+                reach(side, arc.to, new_cost, id);
+            }
+        }
+        side ^= 1;
+    }
+
+    if (middle < 0) {
+        return false;
+    }
+    chain.clear();
+    for (int id = middle; id != source; id = space.parent[0][id]) {
+        chain.push_back(id);
+    }
+    chain.push_back(source);
+    std::reverse(chain.begin(), chain.end());
+    for (int id = middle; id != target; ) {
+        id = space.parent[1][id];
+        chain.push_back(id);
+    }
+    return true;
+}
+
+/**
+ * @brief 递归展开一条向上图中的边
+ *
+ * 捷径的中间格子次序低于两端，对应的两条半边都保存在中间格子的向上边表中
+ *
+ * @param from 边的一端（不追加）
+ * @param to 边的另一端
+ * @param cells 追加from之后直到to的格子编号
+ */
+void Hierarchy::unpack(int from, int to, std::vector<int>& cells) const {
+    int low = rank[from] < rank[to] ? from : to;
+    int high = low == from ? to : from;
+    int middle = -1;
+    for (int k = up_start[low]; k < up_start[low + 1]; k++) {
+        if (up_arcs[k].to == high) {
+            middle = up_arcs[k].middle;
+            break;
+        }
+    }
+    if (middle < 0) {
+        cells.push_back(to);
+        return;
+    }
+    unpack(from, middle, cells);
+    unpack(middle, to, cells);
+}
+
+/**
+ * @brief 查询两点间的路径
+ *
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 展开捷径后的格子路径，不可达时返回空序列
+ */
+std::vector<Intex> Hierarchy::query(const Intex& start, const Intex& goal) const {
+    if (start.x < 0 || start.x >= row_count || start.y < 0 || start.y >= col_count ||
+        goal.x < 0 || goal.x >= row_count || goal.y < 0 || goal.y >= col_count) {
+        return {};
+    }
+    int source = start.x * col_count + start.y;
+    int target = goal.x * col_count + goal.y;
+    if (rank[source] < 0 || rank[target] < 0) {
+        return {};
+    }
+
+    std::vector<int> chain;
+    double best = 0.0;
+    if (!meet(source, target, chain, best)) {
+        return {};
+    }
+
+    std::vector<int> cells{source};
+    for (size_t i = 0; i + 1 < chain.size(); i++) {
+        unpack(chain[i], chain[i + 1], cells);
+    }
+
+    std::vector<Intex> path;
+    path.reserve(cells.size());
+    for (int id : cells) {
+        path.emplace_back(id / col_count, id % col_count);
+    }
+    return path;
+}
+
+std::vector<Intex> Hierarchy::query(const Ground& ground, const Intex& start, const Intex& goal) const {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    return query(start, goal);
+}
+
+/**
+ * @brief 查询两点间的最短代价
+ *
+ * 对称边权下的代价加上 (h(goal) - h(start)) / 2 即为原始代价
+ *
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 最短代价，不可达时为无穷大
+ */
+double Hierarchy::distance(const Intex& start, const Intex& goal) const {
+    if (start.x < 0 || start.x >= row_count || start.y < 0 || start.y >= col_count ||
+        goal.x < 0 || goal.x >= row_count || goal.y < 0 || goal.y >= col_count) {
+        return std::numeric_limits<double>::infinity();
+    }
+    int source = start.x * col_count + start.y;
+    int target = goal.x * col_count + goal.y;
+    if (rank[source] < 0 || rank[target] < 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    std::vector<int> chain;
+    double best = 0.0;
+    if (!meet(source, target, chain, best)) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return best + (height[target] - height[source]) / 2.0;
+}
+
+/**
+ * @brief 读取元素个数，个数超过文件剩余长度能容纳的元素数时视为损坏
+ */
+static bool read_count(std::ifstream& file, uint64_t unit, uint64_t& count) {
+    if (!read_value(file, count)) {
+        return false;
+    }
+    std::streamoff here = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff end = file.tellg();
+    file.seekg(here);
+    return here >= 0 && end >= here && count <= static_cast<uint64_t>(end - here) / unit;
+}
+
+template <typename T>
+static void write_block(std::ofstream& file, const std::vector<T>& data) {
+    write_value(file, static_cast<uint64_t>(data.size()));
+    for (const auto& value : data) {
+        write_value(file, value);
+    }
+}
+
+template <typename T>
+static bool read_block(std::ifstream& file, std::vector<T>& data) {
+    uint64_t count = 0;
+    if (!read_count(file, sizeof(T), count)) {
+        return false;
+    }
+    data.resize(count);
+    for (auto& value : data) {
+        if (!read_value(file, value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 将索引写入二进制文件
+ *
+ * 所有字段逐个按定长类型写出，边按 to、weight、middle 的顺序写，
+ * 文件格式不依赖结构体的内存布局
+ *
+ * @param filename 文件路径
+ * @return 写入成功返回true
+ */
+bool Hierarchy::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(hierarchy_magic, sizeof(hierarchy_magic));
+    write_value(file, static_cast<int32_t>(row_count));
+    write_value(file, static_cast<int32_t>(col_count));
+    write_value(file, static_cast<uint64_t>(rank.size()));
+    for (int value : rank) {
+        write_value(file, static_cast<int32_t>(value));
+    }
+    write_block(file, height);
+    write_value(file, static_cast<uint64_t>(up_start.size()));
+    for (int value : up_start) {
+        write_value(file, static_cast<int32_t>(value));
+    }
+    write_value(file, static_cast<uint64_t>(up_arcs.size()));
+    for (const auto& arc : up_arcs) {
+        write_value(file, static_cast<int32_t>(arc.to));
+        write_value(file, arc.weight);
+        write_value(file, static_cast<int32_t>(arc.middle));
+    }
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief 从二进制文件读取索引
+ *
+ * 除长度外还检查索引的结构：次序在[-1, size)内，向上图的行偏移单调，
+ * 每条边指向次序更高的格子，捷径的中间格子次序低于两端；
+ * 后一条保证展开捷径的递归必然终止。任何一项不满足时保持原索引不变
+ *
+ * @param filename 文件路径
+ * @return 读取成功返回true
+ */
+bool Hierarchy::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    char magic[sizeof(hierarchy_magic)];
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), hierarchy_magic)) {
+        return false;
+    }
+
+    int32_t rows = 0;
+    int32_t cols = 0;
+    if (!read_value(file, rows) || !read_value(file, cols) || rows < 0 || cols < 0) {
+        return false;
+    }
+    Hierarchy loaded;
+    loaded.row_count = rows;
+    loaded.col_count = cols;
+    size_t size = static_cast<size_t>(rows) * cols;
+
+    std::vector<int32_t> ranks;
+    std::vector<int32_t> starts;
+    uint64_t arc_count = 0;
+    if (!read_block(file, ranks) || !read_block(file, loaded.height) || !read_block(file, starts) ||
+        !read_count(file, 2 * sizeof(int32_t) + sizeof(double), arc_count)) {
+        return false;
+    }
+    if (ranks.size() != size || loaded.height.size() != size || starts.size() != size + 1 ||
+        starts.front() != 0 || static_cast<uint64_t>(starts.back()) != arc_count) {
+        return false;
+    }
+    loaded.rank.assign(ranks.begin(), ranks.end());
+    loaded.up_start.assign(starts.begin(), starts.end());
+    loaded.up_arcs.resize(arc_count);
+    for (auto& arc : loaded.up_arcs) {
+        int32_t to = 0;
+        int32_t middle = 0;
+        if (!read_value(file, to) || !read_value(file, arc.weight) || !read_value(file, middle)) {
+            return false;
+        }
+        arc.to = to;
+        arc.middle = middle;
+    }
+
+    int limit = static_cast<int>(size);
+    for (int v = 0; v < limit; v++) {
+        int order = loaded.rank[v];
+        int begin = loaded.up_start[v];
+        int end = loaded.up_start[v + 1];
+        if (order < -1 || order >= limit || begin > end || (order < 0 && begin != end)) {
+            return false;
+        }
+        for (int k = begin; k < end; k++) {
+            const Arc& arc = loaded.up_arcs[k];
+            if (arc.to < 0 || arc.to >= limit || loaded.rank[arc.to] <= order || !(arc.weight >= 0.0)) {
+                return false;
+            }
+            if (arc.middle != -1 && (arc.middle < 0 || arc.middle >= limit ||
+                loaded.rank[arc.middle] < 0 || loaded.rank[arc.middle] >= order)) {
+                return false;
+            }
+        }
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+bool Hierarchy::empty() const {
+    return rank.empty();
+}
+
+int Hierarchy::rows() const {
+    return row_count;
+}
+
+int Hierarchy::cols() const {
+    return col_count;
+}
@@ -0,0 +1,165 @@
+#include "aStar/landmark.hpp"
+
+Landmarks::Landmarks(): row_count(0), col_count(0), ground_id(0), ground_version(0), slack(0.0) {}
+
+/**
+ * @brief 构造函数，选取地标并计算距离表
+ *
+ * 采用最远点选取：先从靠近地图中心的可通行格子出发找到最远格子作为第一个地标，
+ * 之后每次选取到已有地标最近距离最大的格子，每个地标只需一次单源最短路径
+ *
+ * @param graph 二维地图对象
+ * @param count 地标数量
+ */
+Landmarks::Landmarks(const SqPlain& graph, int count):
+    row_count(graph.rows()), col_count(graph.cols()), ground_id(0), ground_version(0), slack(0.0) {
+
+    if (graph.empty() || count <= 0) {
+        return;
+    }
+    int rows = graph.rows();
+    int cols = graph.cols();
+
+    Intex center(rows / 2, cols / 2);
+    Intex seed(-1, -1);
+    double seed_distance = std::numeric_limits<double>::infinity();
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < cols; y++) {
+            Intex point(x, y);
+            if (!graph.edge_allowed(point)) {
+                continue;
+            }
+            if (graph[x][y] != std::floor(graph[x][y])) {
+                slack = 1.0;
+            }
+            double distance = manhattan_distance(point, center);
+            if (distance < seed_distance) {
+                seed_distance = distance;
+                seed = point;
+            }
+        }
+    }
+    if (seed == Intex(-1, -1)) {
+        return;
+    }
+
+    std::vector<double> nearest = delta_stepping(graph, seed);
+    for (int k = 0; k < count; k++) {
+        size_t best = 0;
+        double best_distance = -1.0;
+        for (size_t id = 0; id < nearest.size(); id++) {
+            if (nearest[id] != std::numeric_limits<double>::infinity() && nearest[id] > best_distance) {
+                best_distance = nearest[id];
+                best = id;
+            }
+        }
+        if (best_distance <= 0.0 && k > 0) {
+            break;
+        }
+
+        Intex anchor(static_cast<int>(best / cols), static_cast<int>(best % cols));
+        auto distance = delta_stepping(graph, anchor);
+
+        std::vector<uint32_t> table(distance.size(), unreachable);
+        for (size_t id = 0; id < distance.size(); id++) {
+            if (distance[id] == std::numeric_limits<double>::infinity()) {
+                continue;
+            }
+            double floored = std::floor(distance[id]);
+            table[id] = static_cast<uint32_t>(std::min(floored, static_cast<double>(unreachable - 1)));
+            nearest[id] = k == 0 ? distance[id] : std::min(nearest[id], distance[id]);
+        }
+
+        anchors.push_back(anchor);
+        tables.emplace_back(std::move(table));
+    }
+}
+
+Landmarks::Landmarks(const Ground& ground, int count): Landmarks(ground.map, count) {
+    ground_id = ground.id();
+    ground_version = ground.version();
+}
+
+/**
+ * @brief 计算从at到goal的代价下界
+ *
+ * 单步代价只与目标格子高度有关，反向路径代价 d(v,L) = d(L,v) + h(L) - h(v)，
+ * 因此一张正向距离表即可同时给出两个方向的三角不等式下界：
+ * d(v,t) >= d(L,t) - d(L,v) 与 d(v,t) >= d(L,v) - d(L,t) - h(v) + h(t)
+ *
+ * @param graph 构建地标时使用的地图
+ * @param at 当前点
+ * @param goal 终点
+ * @return 代价下界
+ */
+double Landmarks::heuristic(const SqPlain& graph, const Intex& at, const Intex& goal) const {
+    double best = manhattan_distance(at, goal);
+    size_t v = static_cast<size_t>(at.x) * col_count + at.y;
+    size_t t = static_cast<size_t>(goal.x) * col_count + goal.y;
+    double lift = graph[at.x][at.y] - graph[goal.x][goal.y];
+
+    for (const auto& table : tables) {
+        if (table[v] == unreachable || table[t] == unreachable) {
+            continue;
+        }
+        double forward = static_cast<double>(table[t]) - static_cast<double>(table[v]);
+        double backward = -forward - lift;
+        best = std::max(best, std::max(forward, backward) - slack);
+    }
+    return best;
+}
+
+bool Landmarks::fresh(const Ground& ground) const {
+    return ground_id == ground.id() && ground_version == ground.version() &&
+           row_count == ground.rows() && col_count == ground.cols();
+}
+
+bool Landmarks::empty() const {
+    return tables.empty();
+}
+
+int Landmarks::rows() const {
+    return row_count;
+}
+
+int Landmarks::cols() const {
+    return col_count;
+}
+
+/**
+ * @brief 使用地标启发式的A*搜索
+ *
+ * 与a_star_search的代价定义相同，仅将曼哈顿距离替换为地标下界；
+ * 地图修改后旧地标的下界可能高估代价，Ground重载此时退回a_star_search
+ *
+ * @param graph 二维地图对象
+ * @param marks 由graph构建的地标
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 从起点到终点的路径点序列，不可达或地标与graph尺寸不符时返回空序列
+ */
+std::vector<Intex> alt_star(const Ground& ground, const Landmarks& marks, const Intex& start, const Intex& goal) {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    if (!marks.fresh(ground)) {
+        return a_star_search(ground, start, goal);
+    }
+    return alt_star(ground.map, marks, start, goal);
+}
+
+std::vector<Intex> alt_star(const SqPlain& graph, const Landmarks& marks, const Intex& start, const Intex& goal) {
+
+    // 距离表按构建时的列数索引，尺寸不符时会越界
+    if (graph.rows() != marks.rows() || graph.cols() != marks.cols()) {
+        return {};
+    }
+    if (!graph.edge_allowed(start) || !graph.edge_allowed(goal)) {
+        return {};
+    }
+    int target = goal.x * graph.cols() + goal.y;
+    return grid_star(graph, start,
+                     [&](const Intex& at) { return marks.heuristic(graph, at, goal); },
+                     nullptr,
+                     [target](int id) { return id == target; });
+}
@@ -0,0 +1,201 @@
+#include "aStar/matrix.hpp"
+
+/**
+ * @brief 从一个源点出发的多目标Dijkstra，所有需要的目标都确定后提前结束
+ *
+ * distance为全图大小的工作数组，调用前后均为无穷大，只重置本次写过的格子
+ */
+static std::vector<double> settle(const SqPlain& graph, int source, const std::vector<Intex>& points,
+                                  const std::vector<char>& wanted, std::vector<double>& distance) {
+
+    int cols = graph.cols();
+    int count = static_cast<int>(points.size());
+    std::vector<double> row(count, std::numeric_limits<double>::infinity());
+    const Intex& from = points[source];
+    if (!graph.edge_allowed(from)) {
+        return row;
+    }
+
+    // 同一格子可能对应多个路径点
+    std::unordered_map<int, std::vector<int>> owners;
+    for (int i = 0; i < count; i++) {
+        if (!wanted[i] || !graph.edge_allowed(points[i])) continue;
+        owners[points[i].x * cols + points[i].y].push_back(i);
+    }
+    int remaining = static_cast<int>(owners.size());
+
+    using que_unit = std::pair<double, int>;
+    std::priority_queue<que_unit, std::vector<que_unit>, std::greater<que_unit>> frontier;
+    std::vector<int> touched;
+    int origin = from.x * cols + from.y;
+    distance[origin] = 0.0;
+    touched.push_back(origin);
+    frontier.push({0.0, origin});
+
+    while (!frontier.empty() && remaining > 0) {
+        auto top = frontier.top();
+        frontier.pop();
+        if (top.first > distance[top.second]) continue;
+
+        auto found = owners.find(top.second);
+        if (found != owners.end()) {
+            for (int owner : found->second) {
+                row[owner] = top.first;
+            }
+            remaining--;
+        }
+
+        Intex current(top.second / cols, top.second % cols);
+        for (int idx = 0; idx < 4; idx++) {
+            Intex next = graph.get_neighbour(current, idx);
+            if (!graph.edge_allowed(next)) continue;
+            int id = next.x * cols + next.y;
+            double new_cost = top.first + graph.cost(current, next);
+            if (new_cost < distance[id]) {
+                if (distance[id] == std::numeric_limits<double>::infinity()) {
+                    touched.push_back(id);
+                }
+                distance[id] = new_cost;
+                frontier.push({new_cost, id});
+            }
+        }
+    }
+
+    for (int id : touched) {
+        distance[id] = std::numeric_limits<double>::infinity();
+    }
+    return row;
+}
+
+/**
+ * @brief 按掩码计算代价矩阵，wanted[i * N + j]为0的点对不需要求值
+ */
+static std::vector<std::vector<double>> fill_matrix(const SqPlain& graph, const std::vector<Intex>& points,
+                                                   const std::vector<char>& wanted, int threads) {
+
+    int count = static_cast<int>(points.size());
+    std::vector<std::vector<double>> matrix(count);
+    if (count == 0 || graph.empty()) {
+        return matrix;
+    }
+    if (threads <= 0) {
+        threads = hardware_threads();
+    }
+
+    std::atomic<int> next(0);
+    parallel_for(0, std::min(threads, count), [&](int, int) {
+        std::vector<double> distance(static_cast<size_t>(graph.rows()) * graph.cols(), std::numeric_limits<double>::infinity());
+        for (int source = next++; source < count; source = next++) {
+            std::vector<char> mask(wanted.begin() + static_cast<size_t>(source) * count,
+                                   wanted.begin() + static_cast<size_t>(source + 1) * count);
+            matrix[source] = settle(graph, source, points, mask, distance);
+        }
+    }, threads);
+    return matrix;
+}
+
+/**
+ * @brief 计算若干路径点之间的两两最短代价
+ *
+ * 每个源点只做一次多目标Dijkstra，全部目标确定后即停止，N个点共N次搜索而非N²次；
+ * 源点由各线程从共享计数器领取，每个线程复用一份全图大小的工作数组
+ *
+ * @param graph 二维地图对象
+ * @param points 路径点序列
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ * @return N×N代价矩阵，matrix[i][j]为从points[i]到points[j]的代价，不可达为无穷大
+ */
+std::vector<std::vector<double>> cost_matrix(const SqPlain& graph, const std::vector<Intex>& points, int threads) {
+    std::vector<char> wanted(points.size() * points.size(), 1);
+    return fill_matrix(graph, points, wanted, threads);
+}
+
+std::vector<std::vector<double>> cost_matrix(const Ground& ground, const std::vector<Intex>& points, int threads) {
+    size_t count = points.size();
+    std::vector<char> wanted(count * count, 0);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < count; j++) {
+            wanted[i * count + j] = ground.reachable(points[i], points[j]) ? 1 : 0;
+        }
+    }
+    return fill_matrix(ground.map, points, wanted, threads);
+}
+
+double tour_cost(const std::vector<std::vector<double>>& matrix, const std::vector<int>& order, bool closed) {
+    double total = 0.0;
+    for (size_t i = 1; i < order.size(); i++) {
+        total += matrix[order[i - 1]][order[i]];
+    }
+    if (closed && order.size() > 1) {
+        total += matrix[order.back()][order.front()];
+    }
+    return total;
+}
+
+/**
+ * @brief 启发式求路径点的访问顺序
+ *
+ * 先用最近邻构造初始顺序，再反复做2-opt区段翻转直到没有改进；
+ * 代价矩阵不一定对称，因此每次翻转都重新计算区段内的代价
+ *
+ * @param matrix 代价矩阵
+ * @param first 第一个访问的点
+ * @param closed 是否回到第一个点
+ * @return 点的下标序列，以first开头
+ */
+std::vector<int> visit_order(const std::vector<std::vector<double>>& matrix, int first, bool closed) {
+
+    int count = static_cast<int>(matrix.size());
+    if (count == 0 || first < 0 || first >= count) {
+        return {};
+    }
+
+    std::vector<int> order{first};
+    std::vector<char> visited(count, 0);
+    visited[first] = 1;
+    for (int step = 1; step < count; step++) {
+        int at = order.back();
+        int best = -1;
+        for (int next = 0; next < count; next++) {
+            if (visited[next]) continue;
+            if (best < 0 || matrix[at][next] < matrix[at][best]) {
+                best = next;
+            }
+        }
+        visited[best] = 1;
+        order.push_back(best);
+    }
+
+    // 翻转 order[i..j]，第一个点保持不动
+    auto span_cost = [&](int i, int j, bool reversed) {
+        double total = 0.0;
+        int last = j + 1 < count ? order[j + 1] : (closed ? order[0] : -1);
+        int prev = order[i - 1];
+        for (int k = 0; k <= j - i; k++) {
+            int at = reversed ? order[j - k] : order[i + k];
+            total += matrix[prev][at];
+            prev = at;
+        }
+        if (last >= 0) {
+            total += matrix[prev][last];
+        }
+        return total;
+    };
+
+    const int max_rounds = 100;
+    bool improved = true;
+    for (int round = 0; round < max_rounds && improved; round++) {
+        improved = false;
+        for (int i = 1; i + 1 < count; i++) {
+            for (int j = i + 1; j < count; j++) {
+                double before = span_cost(i, j, false);
+                double after = span_cost(i, j, true);
+                if (after + 1e-9 < before) {
+                    std::reverse(order.begin() + i, order.begin() + j + 1);
+                    improved = true;
+                }
+            }
+        }
+    }
+    return order;
+}
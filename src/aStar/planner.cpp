@@ -0,0 +1,51 @@
+#include "aStar/planner.hpp"
+
+Planner::Planner(const Ground& ground, int threads):
+    ground(ground), worker_count(threads > 0 ? threads : hardware_threads()) {}
+
+std::vector<Intex> Planner::plan(const Intex& start, const Intex& goal) const {
+    thread_local SearchSpace space;
+    return search(start, goal, space);
+}
+
+/**
+ * @brief 批量查询
+ *
+ * 每个工作线程持有一个工作区，查询之间互不依赖，结果按查询下标存放
+ *
+ * @param queries 查询序列
+ * @return 与queries一一对应的路径，结果与线程数无关
+ */
+std::vector<std::vector<Intex>> Planner::plan(const std::vector<Query>& queries) const {
+    int count = static_cast<int>(queries.size());
+    std::vector<std::vector<Intex>> paths(count);
+    std::atomic<int> next(0);
+    parallel_for(0, std::min(worker_count, count), [&](int, int) {
+        SearchSpace space;
+        for (int query = next++; query < count; query = next++) {
+            paths[query] = search(queries[query].start, queries[query].goal, space);
+        }
+    }, worker_count);
+    return paths;
+}
+
+int Planner::threads() const {
+    return worker_count;
+}
+
+/**
+ * @brief 在工作区上执行A*，先用连通分量排除不可达的查询
+ */
+std::vector<Intex> Planner::search(const Intex& start, const Intex& goal, SearchSpace& space) const {
+
+    const SqPlain& graph = ground.map;
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    int target = goal.x * graph.cols() + goal.y;
+    return grid_star(graph, start,
+                     [&](const Intex& at) { return manhattan_distance(at, goal); },
+                     [this](const Intex& at) { return ground.edge_allowed(at); },
+                     [target](int id) { return id == target; },
+                     space);
+}
@@ -0,0 +1,331 @@
+#include "aStar/quadtree.hpp"
+
+QuadLeaf::QuadLeaf(int x, int y, int size, double height, bool blocked):
+    x(x), y(y), size(size), height(height), blocked(blocked) {}
+
+bool QuadLeaf::contains(const Intex& point) const {
+    return point.x >= x && point.x < x + size && point.y >= y && point.y < y + size;
+}
+
+Intex QuadLeaf::center() const {
+    return Intex(x + size / 2, y + size / 2);
+}
+
+Intex QuadLeaf::clamp(const Intex& point) const {
+    return Intex(std::min(std::max(point.x, x), x + size - 1),
+                 std::min(std::max(point.y, y), y + size - 1));
+}
+
+QuadTree::QuadTree(): min_height(0.0), row_count(0), col_count(0) {}
+
+/**
+ * @brief 构造函数，从地图构建四叉树
+ *
+ * 地图先按max_size切分为若干根块，每个根块递归四分，
+ * 直到区域内全部为障碍，或全部可通行且高度差不超过tolerance
+ *
+ * @param graph 原始地图
+ * @param tolerance 允许合并的最大高度差
+ * @param max_size 叶子的最大边长
+ */
+QuadTree::QuadTree(const SqPlain& graph, double tolerance, int max_size):
+    min_height(0.0), row_count(0), col_count(0) {
+
+    if (graph.empty()) {
+        return;
+    }
+    row_count = graph.rows();
+    col_count = graph.cols();
+    owner.assign(static_cast<size_t>(row_count) * col_count, -1);
+
+    int root = 1;
+    while (root < max_size) {
+        root <<= 1;
+    }
+
+    for (int x = 0; x < row_count; x += root) {
+        for (int y = 0; y < col_count; y += root) {
+            divide(graph, x, y, root, tolerance);
+        }
+    }
+
+    min_height = std::numeric_limits<double>::infinity();
+    for (const auto& leaf : leaves) {
+        if (!leaf.blocked) {
+            min_height = std::min(min_height, leaf.height);
+        }
+    }
+    if (min_height == std::numeric_limits<double>::infinity()) {
+        min_height = 0.0;
+    }
+
+    connect();
+}
+
+/**
+ * @brief 递归划分区域
+ *
+ * @param graph 原始地图
+ * @param x 区域左上角行坐标
+ * @param y 区域左上角列坐标
+ * @param size 区域边长
+ * @param tolerance 允许合并的最大高度差
+ */
+void QuadTree::divide(const SqPlain& graph, int x, int y, int size, double tolerance) {
+    if (x >= row_count || y >= col_count) {
+        return;
+    }
+
+    bool inside = x + size <= row_count && y + size <= col_count;
+    if (inside) {
+        bool any_free = false;
+        bool any_blocked = false;
+        double low = std::numeric_limits<double>::infinity();
+        double high = -std::numeric_limits<double>::infinity();
+        double total = 0.0;
+
+        auto uniform = [&]() {
+            for (int i = x; i < x + size; i++) {
+                for (int j = y; j < y + size; j++) {
+                    if (!graph.edge_allowed(Intex(i, j))) {
+                        any_blocked = true;
+                    } else {
+                        any_free = true;
+                        low = std::min(low, graph[i][j]);
+                        high = std::max(high, graph[i][j]);
+                        total += graph[i][j];
+                    }
+                    if ((any_blocked && any_free) || (any_free && high - low > tolerance)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        if (uniform()) {
+            int id = static_cast<int>(leaves.size());
+            double height = any_free ? total / (static_cast<double>(size) * size) : 0.0;
+            leaves.emplace_back(x, y, size, height, !any_free);
+            for (int i = x; i < x + size; i++) {
+                std::fill(owner.begin() + static_cast<size_t>(i) * col_count + y,
+                          owner.begin() + static_cast<size_t>(i) * col_count + y + size, id);
+            }
+            return;
+        }
+    }
+
+    int half = size / 2;
+    divide(graph, x, y, half, tolerance);
+    divide(graph, x, y + half, half, tolerance);
+    divide(graph, x + half, y, half, tolerance);
+    divide(graph, x + half, y + half, half, tolerance);
+}
+
+/**
+ * @brief 沿每个叶子的四条边扫描，建立叶子邻接表
+ */
+void QuadTree::connect() {
+    link_start.assign(leaves.size() + 1, 0);
+    links.clear();
+
+    std::vector<int> around;
+    for (size_t id = 0; id < leaves.size(); id++) {
+        const auto& leaf = leaves[id];
+        around.clear();
+
+        auto take = [&](int i, int j) {
+            if (i < 0 || i >= row_count || j < 0 || j >= col_count) {
+                return;
+            }
+            int other = owner[static_cast<size_t>(i) * col_count + j];
+            if (around.empty() || around.back() != other) {
+                around.push_back(other);
+            }
+        };
+
+        for (int j = leaf.y; j < leaf.y + leaf.size; j++) {
+            take(leaf.x - 1, j);
+            take(leaf.x + leaf.size, j);
+        }
+        for (int i = leaf.x; i < leaf.x + leaf.size; i++) {
+            take(i, leaf.y - 1);
+            take(i, leaf.y + leaf.size);
+        }
+
+        std::sort(around.begin(), around.end());
+        around.erase(std::unique(around.begin(), around.end()), around.end());
+        links.insert(links.end(), around.begin(), around.end());
+        link_start[id + 1] = static_cast<int>(links.size());
+    }
+}
+
+int QuadTree::locate(const Intex& point) const {
+    if (point.x < 0 || point.x >= row_count || point.y < 0 || point.y >= col_count) {
+        return -1;
+    }
+    return owner[static_cast<size_t>(point.x) * col_count + point.y];
+}
+
+std::vector<int> QuadTree::adjacent(int leaf) const {
+    return std::vector<int>(links.begin() + link_start[leaf], links.begin() + link_start[leaf + 1]);
+}
+
+bool QuadTree::empty() const {
+    return leaves.empty();
+}
+
+int QuadTree::rows() const {
+    return row_count;
+}
+
+int QuadTree::cols() const {
+    return col_count;
+}
+
+/**
+ * @brief 在矩形区域内以阶梯方式连接两个格子
+ *
+ * 每一步沿剩余差值较大的方向移动一格，路径始终位于两点包围盒内
+ *
+ * @param path 路径序列，追加from之后直到to的格子
+ * @param from 起始格子（不追加）
+ * @param to 目标格子
+ */
+static void stair(std::vector<Intex>& path, Intex from, const Intex& to) {
+    while (from != to) {
+        int dx = to.x - from.x;
+        int dy = to.y - from.y;
+        if (std::abs(dx) >= std::abs(dy)) {
+            from.x += dx > 0 ? 1 : -1;
+        } else {
+            from.y += dy > 0 ? 1 : -1;
+        }
+        path.push_back(from);
+    }
+}
+
+/**
+ * @brief 计算从叶子a进入相邻叶子b的跨越格子对
+ *
+ * @param a 当前叶子
+ * @param b 下一个叶子
+ * @param current 当前所在格子，跨越点选在公共边上离它最近的位置
+ * @return 离开a的格子与进入b的格子
+ */
+static std::pair<Intex, Intex> crossing(const QuadLeaf& a, const QuadLeaf& b, const Intex& current) {
+    if (b.x == a.x + a.size || b.x + b.size == a.x) {
+        int low = std::max(a.y, b.y);
+        int high = std::min(a.y + a.size, b.y + b.size) - 1;
+        int col = std::min(std::max(current.y, low), high);
+        if (b.x == a.x + a.size) {
+            return {Intex(a.x + a.size - 1, col), Intex(b.x, col)};
+        }
+        return {Intex(a.x, col), Intex(b.x + b.size - 1, col)};
+    }
+
+    int low = std::max(a.x, b.x);
+    int high = std::min(a.x + a.size, b.x + b.size) - 1;
+    int row = std::min(std::max(current.x, low), high);
+    if (b.y == a.y + a.size) {
+        return {Intex(row, a.y + a.size - 1), Intex(row, b.y)};
+    }
+    return {Intex(row, a.y), Intex(row, b.y + b.size - 1)};
+}
+
+/**
+ * @brief 在四叉树叶子上进行A*搜索并细化为格子路径
+ *
+ * 叶子之间的代价按中心曼哈顿距离乘以平均单步代价估计，
+ * 得到叶子序列后，在每个叶子内部以阶梯方式连接跨越点，
+ * 由于叶子内部无障碍且为凸区域，细化结果始终是连续可行的格子路径
+ *
+ * @param graph 原始地图
+ * @param tree 由graph构建的四叉树
+ * @param start 起点坐标
+ * @param goal 终点坐标
+ * @return 从起点到终点的格子路径，不可达或四叉树与地图尺寸不符时返回空序列
+ */
+std::vector<Intex> quad_star(const SqPlain& graph, const QuadTree& tree, const Intex& start, const Intex& goal) {
+
+    // 四叉树须由同样尺寸的地图构建，否则叶子与格子对不上
+    if (graph.rows() != tree.rows() || graph.cols() != tree.cols()) {
+        return {};
+    }
+
+    int from = tree.locate(start);
+    int to = tree.locate(goal);
+    if (from < 0 || to < 0 || tree.leaves[from].blocked || tree.leaves[to].blocked) {
+        return {};
+    }
+
+    const auto& leaves = tree.leaves;
+    double unit = 1.0 + std::max(0.0, tree.min_height);
+    auto heuristic = [&](int leaf) {
+        return manhattan_distance(leaves[leaf].center(), goal) * unit;
+    };
+    auto weight = [&](int a, int b) {
+        double step = 1.0 + (leaves[a].height + leaves[b].height) / 2.0;
+        return manhattan_distance(leaves[a].center(), leaves[b].center()) * step;
+    };
+
+    using que_unit = std::pair<double, int>;
+    auto cmp = [](const que_unit& a, const que_unit& b) {
+        return a.first > b.first;
+    };
+    std::priority_queue<que_unit, std::vector<que_unit>, decltype(cmp)> frontier(cmp);
+    std::vector<double> cost_so_far(leaves.size(), std::numeric_limits<double>::infinity());
+    std::vector<int> came_from(leaves.size(), -1);
+    std::vector<bool> closed(leaves.size(), false);
+
+    cost_so_far[from] = 0.0;
+    frontier.push({heuristic(from), from});
+    while (!frontier.empty()) {
+        int current = frontier.top().second;
+        frontier.pop();
+        if (current == to) break;
+        if (closed[current]) continue;
+        closed[current] = true;
+
+        for (int next : tree.adjacent(current)) {
+            if (leaves[next].blocked || closed[next]) {
+                continue;
+            }
+            double new_cost = cost_so_far[current] + weight(current, next);
+            if (new_cost < cost_so_far[next]) {
+                cost_so_far[next] = new_cost;
+                came_from[next] = current;
+                frontier.push({new_cost + heuristic(next), next});
+            }
+        }
+    }
+
+    if (from != to && came_from[to] < 0) {
+        return {};
+    }
+
+    std::vector<int> chain;
+    for (int leaf = to; leaf != from; leaf = came_from[leaf]) {
+        chain.push_back(leaf);
+    }
+    chain.push_back(from);
+    std::reverse(chain.begin(), chain.end());
+
+    std::vector<Intex> path{start};
+    Intex current = start;
+    for (size_t i = 0; i + 1 < chain.size(); i++) {
+        auto pass = crossing(leaves[chain[i]], leaves[chain[i + 1]], current);
+        stair(path, current, pass.first);
+        path.push_back(pass.second);
+        current = pass.second;
+    }
+    stair(path, current, goal);
+    return path;
+}
+
+std::vector<Intex> quad_star(const Ground& ground, const QuadTree& tree, const Intex& start, const Intex& goal) {
+    if (!ground.reachable(start, goal)) {
+        return {};
+    }
+    return quad_star(ground.map, tree, start, goal);
+}
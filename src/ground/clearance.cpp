@@ -0,0 +1,169 @@
+#include "ground/clearance.hpp"
+
+Clearance::Clearance(): row_count(0), col_count(0) {}
+
+Clearance::Clearance(const Bitmap& obstacles, int threads): row_count(0), col_count(0) {
+    rebuild(obstacles, threads);
+}
+
+/**
+ * @brief 重新计算整张距离场
+ *
+ * 第一遍各线程负责若干列，求每个格子到同列最近障碍的行距离；
+ * 第二遍各线程负责若干行，对行内的竖直平方距离求抛物线下包络
+ *
+ * @param obstacles 障碍位图
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ */
+void Clearance::rebuild(const Bitmap& obstacles, int threads) {
+    row_count = obstacles.rows();
+    col_count = obstacles.cols();
+    size_t size = static_cast<size_t>(row_count) * col_count;
+    vertical.assign(size, -1);
+    squared.assign(size, far);
+    if (size == 0) {
+        return;
+    }
+
+    parallel_for(0, col_count, [&](int lo, int hi) {
+        for (int y = lo; y < hi; y++) {
+            column(obstacles, y);
+        }
+    }, threads);
+
+    parallel_for(0, row_count, [&](int lo, int hi) {
+        std::vector<int64_t> f(col_count);
+        std::vector<int> hull(col_count);
+        std::vector<double> bound(col_count + 1);
+        for (int x = lo; x < hi; x++) {
+            row(x, f, hull, bound);
+        }
+    }, threads);
+}
+
+/**
+ * @brief 单个格子的障碍状态改变后更新距离场
+ *
+ * 竖直距离只在被修改的列中变化，重新计算该列后，
+ * 只对竖直距离发生变化的行重新求下包络
+ *
+ * @param obstacles 修改后的障碍位图
+ * @param cell 被修改的格子
+ */
+void Clearance::update(const Bitmap& obstacles, const Intex& cell) {
+    if (obstacles.rows() != row_count || obstacles.cols() != col_count) {
+        rebuild(obstacles);
+        return;
+    }
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return;
+    }
+
+    std::vector<int> before(row_count);
+    for (int x = 0; x < row_count; x++) {
+        before[x] = vertical[static_cast<size_t>(x) * col_count + cell.y];
+    }
+    column(obstacles, cell.y);
+
+    std::vector<int64_t> f(col_count);
+    std::vector<int> hull(col_count);
+    std::vector<double> bound(col_count + 1);
+    for (int x = 0; x < row_count; x++) {
+        if (vertical[static_cast<size_t>(x) * col_count + cell.y] != before[x]) {
+            row(x, f, hull, bound);
+        }
+    }
+}
+
+/**
+ * @brief 计算一列中每个格子到同列最近障碍的行距离
+ */
+void Clearance::column(const Bitmap& obstacles, int y) {
+    int last = -1;
+    for (int x = 0; x < row_count; x++) {
+        if (obstacles.test(x, y)) {
+            last = x;
+        }
+        vertical[static_cast<size_t>(x) * col_count + y] = last < 0 ? -1 : x - last;
+    }
+    last = -1;
+    for (int x = row_count - 1; x >= 0; x--) {
+        if (obstacles.test(x, y)) {
+            last = x;
+        }
+        if (last < 0) continue;
+        int& value = vertical[static_cast<size_t>(x) * col_count + y];
+        if (value < 0 || last - x < value) {
+            value = last - x;
+        }
+    }
+}
+
+/**
+ * @brief 对一行求抛物线 (y - q)^2 + f(q) 的下包络
+ *
+ * @param x 行号
+ * @param f 工作区，行内各列的竖直平方距离
+ * @param hull 工作区，下包络中的抛物线顶点列号
+ * @param bound 工作区，相邻抛物线的分界位置
+ */
+void Clearance::row(int x, std::vector<int64_t>& f, std::vector<int>& hull, std::vector<double>& bound) {
+    size_t base = static_cast<size_t>(x) * col_count;
+    for (int y = 0; y < col_count; y++) {
+        int value = vertical[base + y];
+        f[y] = value < 0 ? far : static_cast<int64_t>(value) * value;
+    }
+
+    int k = -1;
+    for (int q = 0; q < col_count; q++) {
+        if (f[q] == far) continue;
+        double s = -std::numeric_limits<double>::infinity();
+        while (k >= 0) {
+            int p = hull[k];
+            s = (static_cast<double>(f[q] + static_cast<int64_t>(q) * q) - static_cast<double>(f[p] + static_cast<int64_t>(p) * p)) / (2.0 * (q - p));
+            if (s > bound[k]) break;
+            k--;
+        }
+        k++;
+        hull[k] = q;
+        bound[k] = k == 0 ? -std::numeric_limits<double>::infinity() : s;
+        bound[k + 1] = std::numeric_limits<double>::infinity();
+    }
+
+    if (k < 0) {
+        std::fill(squared.begin() + base, squared.begin() + base + col_count, far);
+        return;
+    }
+    int j = 0;
+    for (int y = 0; y < col_count; y++) {
+        while (bound[j + 1] < y) {
+            j++;
+        }
+        int64_t dy = y - hull[j];
+        squared[base + y] = dy * dy + f[hull[j]];
+    }
+}
+
+double Clearance::distance(const Intex& cell) const {
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return std::numeric_limits<double>::infinity();
+    }
+    int64_t value = squared[static_cast<size_t>(cell.x) * col_count + cell.y];
+    return value == far ? std::numeric_limits<double>::infinity() : std::sqrt(static_cast<double>(value));
+}
+
+bool Clearance::clear(const Intex& cell, double margin) const {
+    return distance(cell) >= margin;
+}
+
+int Clearance::rows() const {
+    return row_count;
+}
+
+int Clearance::cols() const {
+    return col_count;
+}
+
+bool Clearance::empty() const {
+    return squared.empty();
+}
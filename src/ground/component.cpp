@@ -0,0 +1,283 @@
+#include "ground/component.hpp"
+
+Components::Pending::Pending(const Pending& other): dirty(other.dirty.load()), seeds(other.seeds) {}
+
+Components::Pending& Components::Pending::operator=(const Pending& other) {
+    if (this != &other) {
+        dirty = other.dirty.load();
+        seeds = other.seeds;
+    }
+    return *this;
+}
+
+Components::Components(): row_count(0), col_count(0) {}
+
+Components::Components(const SqPlain& graph, int threads): row_count(0), col_count(0) {
+    rebuild(graph, threads);
+}
+
+/**
+ * @brief 重新标记整张地图
+ *
+ * 地图按行切分为若干条带，各线程在自己的条带内独立合并（只涉及本条带的格子，互不冲突），
+ * 之后顺序合并相邻条带交界处的格子，最后并行地把每个格子直接指向代表元
+ *
+ * @param graph 二维地图对象
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ */
+void Components::rebuild(const SqPlain& graph, int threads) {
+    row_count = graph.rows();
+    col_count = graph.cols();
+    size_t size = static_cast<size_t>(row_count) * col_count;
+    node.resize(size);
+    parent.resize(size);
+    weight.assign(size, 1);
+    passable.assign(size, 0);
+    pending.seeds.clear();
+    pending.dirty = false;
+    if (size == 0) {
+        return;
+    }
+
+    if (threads <= 0) {
+        threads = hardware_threads();
+    }
+    int strips = std::max(1, std::min(threads, row_count));
+    int height = (row_count + strips - 1) / strips;
+
+    parallel_for(0, strips, [&](int lo, int hi) {
+        for (int s = lo; s < hi; s++) {
+            int top = s * height;
+            int bottom = std::min(top + height, row_count);
+            for (int x = top; x < bottom; x++) {
+                for (int y = 0; y < col_count; y++) {
+                    int id = x * col_count + y;
+                    node[id] = id;
+                    parent[id] = id;
+                    passable[id] = graph.edge_allowed(Intex(x, y)) ? 1 : 0;
+                    if (!passable[id]) continue;
+                    if (y > 0 && passable[id - 1]) {
+                        unite(id, id - 1);
+                    }
+                    if (x > top && passable[id - col_count]) {
+                        unite(id, id - col_count);
+                    }
+                }
+            }
+        }
+    }, strips);
+
+    for (int s = 1; s < strips; s++) {
+        int x = s * height;
+        if (x >= row_count) break;
+        for (int y = 0; y < col_count; y++) {
+            int id = x * col_count + y;
+            if (passable[id] && passable[id - col_count]) {
+                unite(id, id - col_count);
+            }
+        }
+    }
+
+    std::vector<int> root(size);
+    parallel_for(0, row_count, [&](int lo, int hi) {
+        for (size_t id = static_cast<size_t>(lo) * col_count; id < static_cast<size_t>(hi) * col_count; id++) {
+            root[id] = find(static_cast<int>(id));
+        }
+    }, threads);
+    parent.swap(root);
+}
+
+/**
+ * @brief 单个格子的可通行性改变后更新索引
+ *
+ * 格子变为可通行时与相邻的可通行格子合并；
+ * 格子被封堵时先换成新的孤立节点，再在其附近搜索，确认剩余的相邻格子仍然彼此连通；
+ * 搜索超过repair_limit个格子仍无法确认时把相邻格子记为种子，留到下次查询时重新标记，
+ * 此后直到重新标记前的封堵都只记种子、不再搜索，因此沿墙逐格封堵时每次修改为常数时间；
+ * 追加的节点数超过格子数时整体重建
+ *
+ * @param graph 修改后的地图
+ * @param cell 被修改的格子
+ */
+void Components::update(const SqPlain& graph, const Intex& cell) {
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return;
+    }
+    if (graph.rows() != row_count || graph.cols() != col_count) {
+        rebuild(graph);
+        return;
+    }
+    int id = cell.x * col_count + cell.y;
+    uint8_t now = graph.edge_allowed(cell) ? 1 : 0;
+    if (now == passable[id]) {
+        return;
+    }
+    passable[id] = now;
+
+    if (now) {
+        for (int idx = 0; idx < 4; idx++) {
+            Intex next = graph.get_neighbour(cell, idx);
+            if (next.x < 0 || next.x >= row_count || next.y < 0 || next.y >= col_count) continue;
+            int next_id = next.x * col_count + next.y;
+            if (passable[next_id]) {
+                unite(node[id], node[next_id]);
+            }
+        }
+        return;
+    }
+
+    if (parent.size() >= 2 * node.size()) {
+        rebuild(graph);
+        return;
+    }
+    node[id] = static_cast<int>(parent.size());
+    parent.push_back(node[id]);
+    weight.push_back(1);
+    if (pending.dirty || !repair(graph, id)) {
+        mark(graph, id);
+    }
+}
+
+/**
+ * @brief 把被封堵格子的相邻可通行格子记为种子，留到下次查询时重新标记
+ */
+void Components::mark(const SqPlain& graph, int id) {
+    Intex cell(id / col_count, id % col_count);
+    for (int idx = 0; idx < 4; idx++) {
+        Intex next = graph.get_neighbour(cell, idx);
+        if (next.x < 0 || next.x >= row_count || next.y < 0 || next.y >= col_count) continue;
+        int next_id = next.x * col_count + next.y;
+        if (passable[next_id]) {
+            pending.seeds.push_back(next_id);
+        }
+    }
+    pending.dirty = true;
+}
+
+/**
+ * @brief 有待重新标记的种子时重新标记，可由多个线程同时调用
+ */
+void Components::settle() const {
+    if (!pending.dirty.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(pending.lock);
+    if (pending.dirty.load(std::memory_order_relaxed)) {
+        relabel();
+        pending.dirty.store(false, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief 从每个尚未填充的种子出发做洪水填充，每块换成一个新的并查集节点
+ *
+ * 只访问包含种子的连通分量，代价与这些分量的大小成正比
+ */
+void Components::relabel() const {
+    int first = static_cast<int>(parent.size());
+    std::vector<int> frontier;
+    for (int seed : pending.seeds) {
+        if (!passable[seed] || node[seed] >= first) continue;
+        int fresh = static_cast<int>(parent.size());
+        parent.push_back(fresh);
+        weight.push_back(0);
+        node[seed] = fresh;
+        frontier.assign(1, seed);
+        while (!frontier.empty()) {
+            int id = frontier.back();
+            frontier.pop_back();
+            weight[fresh]++;
+            int x = id / col_count;
+            int y = id % col_count;
+            int around[4] = {x > 0 ? id - col_count : -1, x + 1 < row_count ? id + col_count : -1,
+                             y > 0 ? id - 1 : -1, y + 1 < col_count ? id + 1 : -1};
+            for (int next : around) {
+                if (next < 0 || !passable[next] || node[next] >= first) continue;
+                node[next] = fresh;
+                frontier.push_back(next);
+            }
+        }
+    }
+    pending.seeds.clear();
+}
+
+/**
+ * @brief 确认被封堵格子的相邻可通行格子仍然彼此连通
+ *
+ * @param graph 修改后的地图
+ * @param id 被封堵的格子编号
+ * @return 在搜索上限内确认连通时返回true
+ */
+bool Components::repair(const SqPlain& graph, int id) {
+    Intex cell(id / col_count, id % col_count);
+    std::vector<int> around;
+    for (int idx = 0; idx < 4; idx++) {
+        Intex next = graph.get_neighbour(cell, idx);
+        if (next.x < 0 || next.x >= row_count || next.y < 0 || next.y >= col_count) continue;
+        int next_id = next.x * col_count + next.y;
+        if (passable[next_id]) {
+            around.push_back(next_id);
+        }
+    }
+    if (around.size() < 2) {
+        return true;
+    }
+
+    std::unordered_set<int> visited{around[0]};
+    std::queue<int> frontier;
+    frontier.push(around[0]);
+    size_t remaining = around.size() - 1;
+    while (!frontier.empty() && visited.size() <= repair_limit) {
+        Intex current(frontier.front() / col_count, frontier.front() % col_count);
+        frontier.pop();
+        for (int idx = 0; idx < 4; idx++) {
+            Intex next = graph.get_neighbour(current, idx);
+            if (next.x < 0 || next.x >= row_count || next.y < 0 || next.y >= col_count) continue;
+            int next_id = next.x * col_count + next.y;
+            if (!passable[next_id] || !visited.insert(next_id).second) continue;
+            if (std::find(around.begin() + 1, around.end(), next_id) != around.end() && --remaining == 0) {
+                return true;
+            }
+            frontier.push(next_id);
+        }
+    }
+    return false;
+}
+
+int Components::find(int id) const {
+    while (parent[id] != id) {
+        id = parent[id];
+    }
+    return id;
+}
+
+void Components::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+        return;
+    }
+    if (weight[a] < weight[b]) {
+        std::swap(a, b);
+    }
+    parent[b] = a;
+    weight[a] += weight[b];
+}
+
+int Components::label(const Intex& cell) const {
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return -1;
+    }
+    settle();
+    int id = cell.x * col_count + cell.y;
+    return passable[id] ? find(node[id]) : -1;
+}
+
+bool Components::connected(const Intex& a, const Intex& b) const {
+    int la = label(a);
+    return la >= 0 && la == label(b);
+}
+
+bool Components::empty() const {
+    return parent.empty();
+}
@@ -0,0 +1,141 @@
+#include "ground/erosion.hpp"
+
+Erosion::Erosion(): bucket_count(0) {}
+
+/**
+ * @brief 构造函数，对障碍位图按足部形状做腐蚀
+ *
+ * 每个量化朝向的足部覆盖区域取自足部模板，与Foot::cover一致
+ *
+ * @param obstacles 障碍位图
+ * @param length 足部长度
+ * @param width 足部宽度
+ * @param headings 朝向量化数目，覆盖[0, π)
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ */
+Erosion::Erosion(const Bitmap& obstacles, double length, double width, int headings, int threads):
+    bucket_count(std::max(headings, 1)) {
+
+    spans.resize(bucket_count);
+    layers.resize(bucket_count);
+    // 共享模板缓存一周分为2 * bucket_count份，angle(h)恰好落在第h份上
+    StencilCache& stencils = StencilCache::shared(2 * bucket_count);
+    for (int h = 0; h < bucket_count; h++) {
+        spans[h] = stencils.get(length, width, angle(h)).spans;
+        erode(obstacles, h, threads);
+    }
+}
+
+/**
+ * @brief 对一个量化朝向做腐蚀
+ *
+ * 对每种区间宽度w，按van Herk/Gil-Werman方法在每行上分块求前缀与后缀的障碍“或”，
+ * 任意长度为w的窗口都等于一个后缀与一个前缀的“或”，每格只需常数次运算；
+ * 之后把足部各行区间对应的窗口结果逐行合并，得到该朝向的可落足位图；
+ * 窗口结果按位存放，每种宽度一张与地图同尺寸的位图，函数返回时释放
+ *
+ * @param obstacles 障碍位图
+ * @param heading 朝向量化编号
+ * @param threads 线程数
+ */
+void Erosion::erode(const Bitmap& obstacles, int heading, int threads) {
+    int rows = obstacles.rows();
+    int cols = obstacles.cols();
+    const auto& shape = spans[heading];
+    layers[heading] = Bitmap(rows, cols);
+    if (rows == 0 || cols == 0 || shape.empty()) {
+        return;
+    }
+
+    std::vector<int> widths;
+    for (const auto& span : shape) {
+        widths.push_back(span.y1 - span.y0 + 1);
+    }
+    std::sort(widths.begin(), widths.end());
+    widths.erase(std::unique(widths.begin(), widths.end()), widths.end());
+
+    // window[k]的(x, y)为1表示第x行[y, y + w - 1]内有障碍（越界视为障碍）；
+    // 各线程写不同的行，位图每行按字对齐，不会写到同一个字
+    std::vector<Bitmap> window(widths.size(), Bitmap(rows, cols));
+    parallel_for(0, rows, [&](int lo, int hi) {
+        std::vector<uint8_t> blocked(cols);
+        std::vector<uint8_t> prefix(cols);
+        std::vector<uint8_t> suffix(cols);
+        for (int x = lo; x < hi; x++) {
+            for (int y = 0; y < cols; y++) {
+                blocked[y] = obstacles.test(x, y) ? 1 : 0;
+            }
+            for (size_t k = 0; k < widths.size(); k++) {
+                int w = widths[k];
+                for (int y = 0; y < cols; y++) {
+                    prefix[y] = (y % w == 0) ? blocked[y] : static_cast<uint8_t>(prefix[y - 1] | blocked[y]);
+                }
+                for (int y = cols - 1; y >= 0; y--) {
+                    suffix[y] = (y % w == w - 1 || y == cols - 1) ? blocked[y] : static_cast<uint8_t>(suffix[y + 1] | blocked[y]);
+                }
+                Bitmap& out = window[k];
+                for (int y = 0; y < cols; y++) {
+                    int end = y + w - 1;
+                    if (end >= cols || (suffix[y] | prefix[end])) {
+                        out.set(x, y, true);
+                    }
+                }
+            }
+        }
+    }, threads);
+
+    Bitmap& layer = layers[heading];
+    std::vector<int> slot;
+    for (const auto& span : shape) {
+        slot.push_back(static_cast<int>(std::lower_bound(widths.begin(), widths.end(), span.y1 - span.y0 + 1) - widths.begin()));
+    }
+    parallel_for(0, rows, [&](int lo, int hi) {
+        for (int x = lo; x < hi; x++) {
+            for (int y = 0; y < cols; y++) {
+                bool fit = true;
+                for (size_t s = 0; s < shape.size() && fit; s++) {
+                    int row = x + shape[s].x;
+                    int start = y + shape[s].y0;
+                    fit = row >= 0 && row < rows && start >= 0 &&
+                          !window[slot[s]].test(row, start);
+                }
+                if (fit) {
+                    layer.set(x, y, true);
+                }
+            }
+        }
+    }, threads);
+}
+
+int Erosion::heading(double rz) const {
+    double step = M_PI / bucket_count;
+    int index = static_cast<int>(std::lround(rz / step)) % bucket_count;
+    return index < 0 ? index + bucket_count : index;
+}
+
+double Erosion::angle(int heading) const {
+    return heading * M_PI / bucket_count;
+}
+
+bool Erosion::fits(const Intex& centre, int heading) const {
+    if (heading < 0 || heading >= bucket_count) {
+        return false;
+    }
+    return layers[heading].test(centre.x, centre.y);
+}
+
+bool Erosion::fits(const SqDot& centre, double rz) const {
+    return fits(Intex(centre.x_index(), centre.y_index()), heading(rz));
+}
+
+const std::vector<FootSpan>& Erosion::footprint(int heading) const {
+    return spans[heading];
+}
+
+int Erosion::headings() const {
+    return bucket_count;
+}
+
+bool Erosion::empty() const {
+    return layers.empty();
+}
@@ -0,0 +1,224 @@
+#include "ground/foothold.hpp"
+
+#include <cstring>
+
+static const char foothold_magic[8] = {'F', 'O', 'O', 'T', 'H', 'L', 'D', '1'};
+
+Footholds::Footholds(): row_count(0), col_count(0), bucket_count(0), foot_length(0.0), foot_width(0.0), max_angle(0.0), print(0) {}
+
+/**
+ * @brief 构造函数，先按足部形状腐蚀障碍，再对剩余格子并行做坡度判断
+ *
+ * 腐蚀后仍可放置的格子才做坡度判断，坡度判断与Ground::stand_check一致；
+ * 各行占用独立的64位字，按行并行写入同一层位图不会冲突
+ *
+ * @param ground 地面对象
+ * @param length 足部长度
+ * @param width 足部宽度
+ * @param headings 朝向量化数目，覆盖[0, π)
+ * @param limit 拟合平面允许的最大倾角（弧度）
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ */
+Footholds::Footholds(const Ground& ground, double length, double width, int headings, double limit, int threads):
+    row_count(ground.rows()), col_count(ground.cols()), bucket_count(std::max(headings, 1)),
+    foot_length(length), foot_width(width), max_angle(limit), print(fingerprint(ground.map)) {
+
+    Erosion erosion(ground.obstacles(), length, width, bucket_count, threads);
+    layers.resize(bucket_count);
+    for (int h = 0; h < bucket_count; h++) {
+        layers[h] = Bitmap(row_count, col_count);
+        const auto& shape = erosion.footprint(h);
+        int count = static_cast<int>(shape.size());
+        parallel_for(0, row_count, [&](int lo, int hi) {
+            std::vector<FootSpan> placed(shape.size());
+            for (int x = lo; x < hi; x++) {
+                for (int y = 0; y < col_count; y++) {
+                    if (!erosion.fits(Intex(x, y), h)) {
+                        continue;
+                    }
+                    for (int s = 0; s < count; s++) {
+                        placed[s] = FootSpan{x + shape[s].x, y + shape[s].y0, y + shape[s].y1};
+                    }
+                    if (ground.stand_check(placed.data(), count, max_angle)) {
+                        layers[h].set(x, y, true);
+                    }
+                }
+            }
+        }, threads);
+    }
+}
+
+int Footholds::quantize(double rz, int headings) {
+    if (headings <= 0) {
+        return 0;
+    }
+    double step = M_PI / headings;
+    int index = static_cast<int>(std::lround(rz / step)) % headings;
+    return index < 0 ? index + headings : index;
+}
+
+int Footholds::heading(double rz) const {
+    return quantize(rz, bucket_count);
+}
+
+double Footholds::angle(int heading) const {
+    return heading * M_PI / bucket_count;
+}
+
+bool Footholds::fits(const Intex& centre, int heading) const {
+    if (heading < 0 || heading >= bucket_count) {
+        return false;
+    }
+    return layers[heading].test(centre.x, centre.y);
+}
+
+bool Footholds::fits(const SqDot& centre, double rz) const {
+    if (empty()) {
+        return false;
+    }
+    return fits(Intex(centre.x_index(), centre.y_index()), heading(rz));
+}
+
+bool Footholds::matches(const Ground& ground) const {
+    return !empty() && ground.rows() == row_count && ground.cols() == col_count && fingerprint(ground.map) == print;
+}
+
+/**
+ * @brief 地图高度的指纹
+ *
+ * 对尺寸与每格高度的二进制表示做FNV-1a散列
+ *
+ * @param graph 二维地图对象
+ * @return 64位指纹
+ */
+uint64_t Footholds::fingerprint(const SqPlain& graph) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t value) {
+        for (int k = 0; k < 8; k++) {
+            hash ^= (value >> (k * 8)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(static_cast<uint64_t>(graph.rows()));
+    mix(static_cast<uint64_t>(graph.cols()));
+    for (int x = 0; x < graph.rows(); x++) {
+        for (int y = 0; y < graph.cols(); y++) {
+            uint64_t bits = 0;
+            double height = graph[x][y];
+            std::memcpy(&bits, &height, sizeof(bits));
+            mix(bits);
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief 将位图写入二进制文件
+ *
+ * @param filename 文件路径
+ * @return 写入成功返回true
+ */
+bool Footholds::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(foothold_magic, sizeof(foothold_magic));
+    write_value(file, static_cast<int32_t>(row_count));
+    write_value(file, static_cast<int32_t>(col_count));
+    write_value(file, static_cast<int32_t>(bucket_count));
+    write_value(file, foot_length);
+    write_value(file, foot_width);
+    write_value(file, max_angle);
+    write_value(file, print);
+    for (const auto& layer : layers) {
+        const auto& words = layer.data();
+        file.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint64_t)));
+    }
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief 从二进制文件读取位图
+ *
+ * 文件头中的行数、列数和朝向数必须与剩余数据长度恰好相符，
+ * 否则保持原位图不变
+ *
+ * @param filename 文件路径
+ * @return 读取成功返回true
+ */
+bool Footholds::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    char magic[sizeof(foothold_magic)];
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), foothold_magic)) {
+        return false;
+    }
+
+    int32_t rows = 0;
+    int32_t cols = 0;
+    int32_t buckets = 0;
+    Footholds loaded;
+    if (!read_value(file, rows) || !read_value(file, cols) ||
+        !read_value(file, buckets) || !read_value(file, loaded.foot_length) ||
+        !read_value(file, loaded.foot_width) || !read_value(file, loaded.max_angle) ||
+        !read_value(file, loaded.print)) {
+        return false;
+    }
+    if (rows < 0 || cols < 0 || buckets < 1) {
+        return false;
+    }
+    loaded.row_count = rows;
+    loaded.col_count = cols;
+    loaded.bucket_count = buckets;
+    std::streamoff here = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff remaining = file.tellg() - here;
+    file.seekg(here);
+    size_t size = static_cast<size_t>(loaded.row_count) * ((static_cast<size_t>(loaded.col_count) + 63) / 64);
+    size_t layer_bytes = size * sizeof(uint64_t);
+    if (remaining < 0 || (layer_bytes == 0 ? remaining != 0 :
+        static_cast<size_t>(remaining) % layer_bytes != 0 ||
+        static_cast<size_t>(remaining) / layer_bytes != static_cast<size_t>(loaded.bucket_count))) {
+        return false;
+    }
+    for (int h = 0; h < loaded.bucket_count; h++) {
+        std::vector<uint64_t> words(size);
+        if (!file.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(size * sizeof(uint64_t)))) {
+            return false;
+        }
+        loaded.layers.emplace_back(loaded.row_count, loaded.col_count, std::move(words));
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+double Footholds::length() const {
+    return foot_length;
+}
+
+double Footholds::width() const {
+    return foot_width;
+}
+
+double Footholds::limit() const {
+    return max_angle;
+}
+
+int Footholds::headings() const {
+    return bucket_count;
+}
+
+int Footholds::rows() const {
+    return row_count;
+}
+
+int Footholds::cols() const {
+    return col_count;
+}
+
+bool Footholds::empty() const {
+    return layers.empty();
+}
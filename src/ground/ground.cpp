@@ -7,7 +7,7 @@
  * 
  * @param filename 地形数据文件路径
  */
-Ground::Ground(std::string filename) {
+Ground::Ground(std::string filename) : revision(0) {
     CSVReader reader;
     try {
         if (!reader.readFromFile(filename)) {
@@ -15,6 +15,10 @@ Ground::Ground(std::string filename) {
             return;
         } else {
             map = reader.getData();
+            regions.rebuild(map);
+            blocked = Bitmap(map);
+            room.rebuild(blocked);
+            sums = HeightSums(map);
         }
     } catch (std::exception& e) {
         std::cout << "错误: " << e.what() << std::endl;
@@ -22,7 +26,7 @@ Ground::Ground(std::string filename) {
     }
 }
 
-Ground::Ground(int rows, int cols) : map(rows, cols, 0.0) {
+Ground::Ground(int rows, int cols) : map(rows, cols, 0.0), revision(0), regions(map), blocked(map), room(blocked), sums(map) {
 }
 
 /**
@@ -31,10 +35,11 @@ Ground::Ground(int rows, int cols) : map(rows, cols, 0.0) {
  * 该函数通过三点拟合平面来计算区域的倾斜角度
  * 
  * @param area 区域内的点集合
+ * @param mode 拟合方式
  * @return 站立角度（弧度）
  */
-double Ground::stand_angle(std::vector<SqDot>& area) {
-    CuPlain plaine = trip(area);
+double Ground::stand_angle(const std::vector<SqDot>& area, TripMode mode) const {
+    CuPlain plaine = trip(area, mode);
     return plaine.normal_angle();
 }
 
@@ -53,12 +58,32 @@ std::array<int, 2> Ground::shape() const {
 /**
  * @brief 通过区域内的点拟合三维平面
  * 
- * 该函数使用区域内的点数据，通过迭代优化算法拟合最佳平面
+ * 该函数使用区域内的点数据，通过迭代优化算法拟合最佳平面；
+ * LeastSquares模式下一次遍历累计矩，直接求最小二乘平面，区域含障碍时与按行前缀和的结果一样无法拟合
  * 
  * @param area 区域内的点集合
+ * @param mode 拟合方式
  * @return 拟合得到的三维平面
  */
-CuPlain Ground::trip(std::vector<SqDot>& area) { 
+CuPlain Ground::trip(const std::vector<SqDot>& area, TripMode mode) const { 
+    if (mode == TripMode::Convex) {
+        return convex_trip(area);
+    }
+    if (mode == TripMode::LeastSquares) {
+        PlaneMoments moments;
+        for (const auto& point : area) {
+            if (point.x < 0 || point.x >= map.rows() || point.y < 0 || point.y >= map.cols()) {
+                return CuPlain();
+            }
+            if (blocked.test(point.x, point.y)) {
+                moments.invalid++;
+                continue;
+            }
+            moments.add(point.x, point.y, map[point.x][point.y]);
+        }
+        return moments.fit();
+    }
+
     std::vector<CuDot> dots;
     for (const auto& point : area) {
         if (point.x < 0 || point.x >= map.rows() || point.y < 0 || point.y >= map.cols()) {
@@ -123,34 +148,29 @@ CuPlain Ground::trip(std::vector<SqDot>& area) {
     CuPlain plaine;
     plaine.define_plaine(results);
     
+    // 剩余点按分量存放，距离与误差和交给批量核函数
+    thread_local PointBatch rest;
+    rest.clear();
+    for (const auto& dot : dots) {
+        rest.push(dot);
+    }
 
     bool changed = true;
     const int max_iterations = 100;
     int iterations = 0;
     
-    while (changed && !dots.empty() && iterations < max_iterations) {
+    while (changed && !rest.empty() && iterations < max_iterations) {
         changed = false;
         iterations++;
         
 
         double max_distance = 0;
-        int best_point_idx = -1;
-        CuPos best_point_pos;
-        
-        for (size_t i = 0; i < dots.size(); i++) {
-            double distance = plaine.distance(dots[i]);
-            CuPos pos = plaine.get_pos(dots[i]);
-            
-
-            if (pos == CuPos::Above && distance > max_distance) {
-                max_distance = distance;
-                best_point_idx = static_cast<int>(i);
-                best_point_pos = pos;
-            }
-        }
+        int best_point_idx = farthest_above(plaine, rest, max_distance);
         
 
         if (best_point_idx >= 0) {
+            CuDot best_point(rest.x[best_point_idx], rest.y[best_point_idx], rest.z[best_point_idx]);
+            double original_error = plane_error(plaine, rest);
 
             double best_improvement = 0;
             int best_replace_idx = -1;
@@ -158,21 +178,14 @@ CuPlain Ground::trip(std::vector<SqDot>& area) {
             for (int i = 0; i < 3; i++) {
 
                 std::array<CuDot, 3> temp_results = results;
-                temp_results[i] = dots[best_point_idx];
+                temp_results[i] = best_point;
                 
 
                 CuPlain temp_plane;
                 temp_plane.define_plaine(temp_results);
                 
 
-                double original_error = 0;
-                double new_error = 0;
-                
-
-                for (const auto& dot : dots) {
-                    original_error += plaine.distance(dot);
-                    new_error += temp_plane.distance(dot);
-                }
+                double new_error = plane_error(temp_plane, rest);
                 
                 double improvement = original_error - new_error;
                 if (improvement > best_improvement) {
@@ -183,13 +196,13 @@ CuPlain Ground::trip(std::vector<SqDot>& area) {
             
 
             if (best_replace_idx >= 0) {
-                results[best_replace_idx] = dots[best_point_idx];
-                dots.erase(dots.begin() + best_point_idx);
+                results[best_replace_idx] = best_point;
+                rest.erase(best_point_idx);
                 plaine.define_plaine(results);
                 changed = true;
             } else {
 
-                dots.erase(dots.begin() + best_point_idx);
+                rest.erase(best_point_idx);
             }
         } else {
 
@@ -200,26 +213,89 @@ CuPlain Ground::trip(std::vector<SqDot>& area) {
     return plaine;
 }
 
+CuPlain Ground::trip(const FootSpan* spans, int count) const {
+    PlaneMoments moments;
+    for (int k = 0; k < count; k++) {
+        moments.merge(sums.span(spans[k].x, spans[k].y0, spans[k].y1));
+    }
+    return moments.fit();
+}
+
+/**
+ * @brief 在实数坐标的足部矩形内均匀取样插值高度，做最小二乘平面拟合
+ * 
+ * 沿长、宽方向各取ceil(边长 / step) + 1个点（至少2个），含边界；
+ * 取样点放在线程局部的点集中，批量插值后累计矩
+ * 
+ * @param centre 足部中心
+ * @param rz 足部朝向角（弧度）
+ * @param length 足部长度
+ * @param width 足部宽度
+ * @param step 取样间距（格）
+ * @param mode 插值方式
+ * @return 拟合得到的平面，取样点越界或落在障碍上时返回CuPlain()
+ */
+CuPlain Ground::sample_trip(const SqDot& centre, double rz, double length, double width, double step, Interpolation mode) const {
+    if (map.empty() || !(step > 0.0)) {
+        return CuPlain();
+    }
+    int along = std::max(2, static_cast<int>(std::ceil(length / step)) + 1);
+    int across = std::max(2, static_cast<int>(std::ceil(width / step)) + 1);
+    double c = std::cos(rz);
+    double s = std::sin(rz);
+
+    thread_local PointBatch points;
+    points.clear();
+    for (int i = 0; i < along; i++) {
+        double l = length * (static_cast<double>(i) / (along - 1) - 0.5);
+        for (int j = 0; j < across; j++) {
+            double w = width * (static_cast<double>(j) / (across - 1) - 0.5);
+            points.push(centre.x + l * c - w * s, centre.y + l * s + w * c, 0.0);
+        }
+    }
+    HeightSampler sampler(map, blocked);
+    if (sampler.sample(points, mode) != points.size()) {
+        return CuPlain();
+    }
+
+    PlaneMoments moments;
+    for (int k = 0; k < points.size(); k++) {
+        moments.add(points.x[k], points.y[k], points.z[k]);
+    }
+    return moments.fit();
+}
+
 /**
  * @brief 计算指定区域的法向量
  * 
  * @param area 区域内的点集合
+ * @param mode 拟合方式
  * @return 区域的法向量
  */
-CuDot Ground::normal(std::vector<SqDot>& area) {
-    CuPlain plaine = trip(area);
+CuDot Ground::normal(const std::vector<SqDot>& area, TripMode mode) const {
+    CuPlain plaine = trip(area, mode);
     return plaine.normal_vector();
 }
 
 /**
- * @brief 使用凸包算法拟合三维平面（未实现）
+ * @brief 使用凸包算法拟合三维平面
+ * 
+ * 刚性足部落在区域高度点上凸包的某个面上，该面位于区域重心的正上方，
+ * 与迭代拟合不同，结果是精确的支撑平面且不低于区域内任何点
  * 
  * @param area 区域内的点集合
- * @return 三维平面对象
+ * @return 三维平面对象，区域越界、点数不足或共线时返回CuPlain()
  */
-CuPlain Ground::convex_trip(std::vector<SqDot>& area) { 
-
-    return CuPlain();
+CuPlain Ground::convex_trip(const std::vector<SqDot>& area) const { 
+    thread_local std::vector<CuDot> dots;
+    dots.clear();
+    for (const auto& point : area) {
+        if (point.x < 0 || point.x >= map.rows() || point.y < 0 || point.y >= map.cols()) {
+            return CuPlain();
+        }
+        dots.emplace_back(point.x, point.y, map[point.x][point.y]);
+    }
+    return support_plane(dots.data(), static_cast<int>(dots.size()));
 }
 
 /**
@@ -243,7 +319,11 @@ bool Ground::obstacle(const int& x, const int& y) const {
     if (!is_valid(x, y)) {
         return true;
     }
-    return map[x][y] < 0.0;
+    return blocked.test(x, y);
+}
+
+bool Ground::edge_allowed(const Intex& point) const {
+    return is_valid(point.x, point.y) && !blocked.test(point.x, point.y);
 }
 
 bool Ground::set_unit(const int& x, const int& y, bool is_obstacle) {
@@ -251,9 +331,91 @@ bool Ground::set_unit(const int& x, const int& y, bool is_obstacle) {
         return false;
     }
     map[x][y] = is_obstacle ? -1.0 : 0.0;
+    regions.update(map, Intex(x, y));
+    blocked.set(x, y, is_obstacle);
+    room.update(blocked, Intex(x, y));
+    sums.update(map, x);
+    {
+        std::lock_guard<std::mutex> guard(slopes.lock);
+        if (slopes.table) {
+            slopes.table->update(map, Intex(x, y));
+        }
+    }
+    revision++;
     return true;
 }
 
+uint64_t Ground::version() const {
+    return revision;
+}
+
+void Ground::touch() {
+    revision++;
+    regions.rebuild(map);
+    blocked = Bitmap(map);
+    room.rebuild(blocked);
+    sums = HeightSums(map);
+    {
+        std::lock_guard<std::mutex> guard(slopes.lock);
+        slopes.table.reset();
+    }
+}
+
+uint64_t Ground::id() const {
+    return serial.value;
+}
+
+static std::atomic<uint64_t> next_serial(1);
+
+Ground::Serial::Serial(): value(next_serial++) {}
+
+Ground::Serial::Serial(const Serial&): value(next_serial++) {}
+
+Ground::Serial& Ground::Serial::operator=(const Serial&) {
+    value = next_serial++;
+    return *this;
+}
+
+bool Ground::reachable(const Intex& start, const Intex& goal) const {
+    return regions.connected(start, goal);
+}
+
+const Components& Ground::components() const {
+    return regions;
+}
+
+const Bitmap& Ground::obstacles() const {
+    return blocked;
+}
+
+const Clearance& Ground::clearance() const {
+    return room;
+}
+
+const SlopeMap& Ground::slope() const {
+    std::lock_guard<std::mutex> guard(slopes.lock);
+    if (!slopes.table) {
+        slopes.table = std::make_unique<SlopeMap>(map);
+    }
+    return *slopes.table;
+}
+
+Ground::SlopeCache::SlopeCache(const SlopeCache&) {}
+
+Ground::SlopeCache& Ground::SlopeCache::operator=(const SlopeCache&) {
+    std::lock_guard<std::mutex> guard(lock);
+    table.reset();
+    return *this;
+}
+
+bool Ground::stand_check(const FootSpan* spans, int count, double limit) const {
+    CuPlain plane = trip(spans, count);
+    if (plane.C == 0.0) {
+        return false;
+    }
+    return plane.normal_angle() <= limit;
+}
+
 int Ground::rows() const { 
     return map.rows(); 
 }
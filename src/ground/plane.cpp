@@ -0,0 +1,291 @@
+#include "ground/plane.hpp"
+
+void PlaneMoments::add(double x, double y, double z) {
+    if (!std::isfinite(z)) {
+        invalid++;
+        return;
+    }
+    n += 1.0;
+    sx += x;
+    sy += y;
+    sz += z;
+    sxx += x * x;
+    syy += y * y;
+    sxy += x * y;
+    sxz += x * z;
+    syz += y * z;
+}
+
+void PlaneMoments::merge(const PlaneMoments& other) {
+    n += other.n;
+    sx += other.sx;
+    sy += other.sy;
+    sz += other.sz;
+    sxx += other.sxx;
+    syy += other.syy;
+    sxy += other.sxy;
+    sxz += other.sxz;
+    syz += other.syz;
+    invalid += other.invalid;
+}
+
+/**
+ * @brief 最小二乘平面
+ *
+ * 对去中心化后的二阶矩解2×2正规方程得到斜率，再由均值得到截距
+ *
+ * @return 法向量z分量为1的平面，点数不足、共线或含无效高度时返回CuPlain()
+ */
+CuPlain PlaneMoments::fit() const {
+    if (invalid > 0 || n < 3.0) {
+        return CuPlain();
+    }
+    double cxx = sxx - sx * sx / n;
+    double cyy = syy - sy * sy / n;
+    double cxy = sxy - sx * sy / n;
+    double cxz = sxz - sx * sz / n;
+    double cyz = syz - sy * sz / n;
+    double det = cxx * cyy - cxy * cxy;
+    if (det <= 1e-12 * std::max(1.0, cxx * cyy)) {
+        return CuPlain();
+    }
+    double a = (cxz * cyy - cyz * cxy) / det;
+    double b = (cyz * cxx - cxz * cxy) / det;
+    double c = (sz - a * sx - b * sy) / n;
+    return CuPlain(-a, -b, 1.0, -c);
+}
+
+namespace {
+
+/**
+ * @brief 斜率的上界，使增量求解的中间问题有界，xy不共线时最终解不会触及
+ */
+constexpr double slope_bound = 1e6;
+
+/**
+ * @brief 可行性判断的容差
+ */
+constexpr double feasible_eps = 1e-9;
+
+/**
+ * @brief 二维线性规划的约束 alpha * a + beta * b >= gamma
+ */
+struct HalfPlane {
+    double alpha;
+    double beta;
+    double gamma;
+};
+
+/**
+ * @brief 在直线 alpha * a + beta * b = gamma 上求一维线性规划
+ *
+ * 约束为前count个半平面与斜率上界，目标为最大化 ca * a + cb * b
+ *
+ * @return 不可行时返回false
+ */
+bool solve_line(const HalfPlane& line, const HalfPlane* prior, int count, double ca, double cb, double& a, double& b) {
+    double norm = line.alpha * line.alpha + line.beta * line.beta;
+    if (norm < feasible_eps) {
+        return line.gamma <= feasible_eps;
+    }
+    double pa = line.alpha * line.gamma / norm;
+    double pb = line.beta * line.gamma / norm;
+    double da = -line.beta;
+    double db = line.alpha;
+    double low = -INFINITY;
+    double high = INFINITY;
+
+    auto limit = [&](const HalfPlane& half) {
+        double slope = half.alpha * da + half.beta * db;
+        double rest = half.gamma - (half.alpha * pa + half.beta * pb);
+        if (std::abs(slope) < feasible_eps) {
+            return rest <= feasible_eps * (1.0 + std::abs(half.gamma));
+        }
+        if (slope > 0.0) {
+            low = std::max(low, rest / slope);
+        } else {
+            high = std::min(high, rest / slope);
+        }
+        return true;
+    };
+    const HalfPlane box[4] = {{1.0, 0.0, -slope_bound}, {-1.0, 0.0, -slope_bound},
+                              {0.0, 1.0, -slope_bound}, {0.0, -1.0, -slope_bound}};
+    for (const auto& half : box) {
+        if (!limit(half)) return false;
+    }
+    for (int k = 0; k < count; k++) {
+        if (!limit(prior[k])) return false;
+    }
+    if (low > high + feasible_eps * (1.0 + std::abs(low))) {
+        return false;
+    }
+    double gain = ca * da + cb * db;
+    double t = gain > 0.0 ? high : (gain < 0.0 ? low : (low + high) / 2.0);
+    a = pa + t * da;
+    b = pb + t * db;
+    return true;
+}
+
+}
+
+/**
+ * @brief 刚性足部在点集上的支撑平面
+ *
+ * 以重心为原点令 u = x - x̄、v = y - ȳ，问题为在 h >= z_i - a * u_i - b * v_i 下最小化h，
+ * 用Seidel随机增量法求解这个三变量线性规划，期望复杂度O(n)：
+ * 新的点不满足当前最优解时，新最优解必在该点对应的约束面上，
+ * 代入后化为关于(a, b)的二维线性规划，再以同样方式化为一维；
+ * 工作数组按线程复用，不在每次调用时分配
+ *
+ * @param dots 点集
+ * @param count 点数
+ * @return 法向量z分量为1的平面，点数不足、xy共线或含无效高度时返回CuPlain()
+ */
+CuPlain support_plane(const CuDot* dots, int count) {
+    if (count < 3) {
+        return CuPlain();
+    }
+    double cx = 0.0;
+    double cy = 0.0;
+    for (int i = 0; i < count; i++) {
+        if (!std::isfinite(dots[i].z)) {
+            return CuPlain();
+        }
+        cx += dots[i].x;
+        cy += dots[i].y;
+    }
+    cx /= count;
+    cy /= count;
+    double cxx = 0.0;
+    double cyy = 0.0;
+    double cxy = 0.0;
+    for (int i = 0; i < count; i++) {
+        cxx += (dots[i].x - cx) * (dots[i].x - cx);
+        cyy += (dots[i].y - cy) * (dots[i].y - cy);
+        cxy += (dots[i].x - cx) * (dots[i].y - cy);
+    }
+    if (cxx * cyy - cxy * cxy <= 1e-12 * std::max(1.0, cxx * cyy)) {
+        return CuPlain();
+    }
+
+    thread_local std::vector<int> order;
+    thread_local std::vector<HalfPlane> halves;
+    order.resize(count);
+    halves.resize(count);
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    // 固定种子，结果可复现；最高点放在最前面使初始解接近最优
+    std::mt19937 engine(0x5eed);
+    std::shuffle(order.begin(), order.end(), engine);
+    auto top = std::max_element(order.begin(), order.end(), [&](int i, int j) {
+        return dots[i].z < dots[j].z;
+    });
+    std::iter_swap(order.begin(), top);
+
+    auto u = [&](int i) { return dots[i].x - cx; };
+    auto v = [&](int i) { return dots[i].y - cy; };
+
+    // 只有第一个约束时，最优解取在斜率上界的角上
+    int first = order[0];
+    double a = u(first) > 0.0 ? slope_bound : (u(first) < 0.0 ? -slope_bound : 0.0);
+    double b = v(first) > 0.0 ? slope_bound : (v(first) < 0.0 ? -slope_bound : 0.0);
+    double h = dots[first].z - a * u(first) - b * v(first);
+
+    for (int k = 1; k < count; k++) {
+        int i = order[k];
+        double need = dots[i].z - a * u(i) - b * v(i);
+        if (h >= need - feasible_eps * (1.0 + std::abs(need))) continue;
+
+        // 约束面 h = z_i - a * u_i - b * v_i 上，前面的约束化为 a(u_j - u_i) + b(v_j - v_i) >= z_j - z_i，
+        // 目标为最大化 a * u_i + b * v_i
+        for (int m = 0; m < k; m++) {
+            int j = order[m];
+            halves[m] = {u(j) - u(i), v(j) - v(i), dots[j].z - dots[i].z};
+        }
+        double na = u(i) > 0.0 ? slope_bound : (u(i) < 0.0 ? -slope_bound : 0.0);
+        double nb = v(i) > 0.0 ? slope_bound : (v(i) < 0.0 ? -slope_bound : 0.0);
+        for (int m = 0; m < k; m++) {
+            const HalfPlane& half = halves[m];
+            if (half.alpha * na + half.beta * nb >= half.gamma - feasible_eps * (1.0 + std::abs(half.gamma))) continue;
+            if (!solve_line(half, halves.data(), m, u(i), v(i), na, nb)) {
+                return CuPlain();
+            }
+        }
+        a = na;
+        b = nb;
+        h = dots[i].z - a * u(i) - b * v(i);
+    }
+
+    if (std::abs(a) >= slope_bound * 0.5 || std::abs(b) >= slope_bound * 0.5) {
+        return CuPlain();
+    }
+    // z = h + a (x - x̄) + b (y - ȳ)
+    return CuPlain(-a, -b, 1.0, -(h - a * cx - b * cy));
+}
+
+HeightSums::HeightSums(): row_count(0), col_count(0) {}
+
+HeightSums::HeightSums(const SqPlain& graph): row_count(graph.rows()), col_count(graph.cols()) {
+    size_t size = static_cast<size_t>(row_count) * (col_count + 1);
+    z_sum.assign(size, 0.0);
+    yz_sum.assign(size, 0.0);
+    bad_sum.assign(size, 0);
+    for (int x = 0; x < row_count; x++) {
+        update(graph, x);
+    }
+}
+
+void HeightSums::update(const SqPlain& graph, int x) {
+    if (x < 0 || x >= row_count) {
+        return;
+    }
+    size_t base = static_cast<size_t>(x) * (col_count + 1);
+    for (int y = 0; y < col_count; y++) {
+        double z = graph[x][y];
+        // 障碍格子（高度为负或无穷大）与非有限高度一样不能参与拟合
+        bool valid = std::isfinite(z) && graph.edge_allowed(Intex(x, y));
+        z_sum[base + y + 1] = z_sum[base + y] + (valid ? z : 0.0);
+        yz_sum[base + y + 1] = yz_sum[base + y] + (valid ? y * z : 0.0);
+        bad_sum[base + y + 1] = bad_sum[base + y] + (valid ? 0 : 1);
+    }
+}
+
+/**
+ * @brief 第x行[y0, y1]区间的平面矩
+ *
+ * Σz与Σy·z取自前缀和，只与坐标有关的矩用等差、平方和公式直接算出
+ */
+PlaneMoments HeightSums::span(int x, int y0, int y1) const {
+    PlaneMoments moments;
+    if (y1 < y0) {
+        return moments;
+    }
+    if (x < 0 || x >= row_count || y0 < 0 || y1 >= col_count) {
+        moments.invalid = y1 - y0 + 1;
+        return moments;
+    }
+    size_t base = static_cast<size_t>(x) * (col_count + 1);
+    double m = y1 - y0 + 1;
+    // Σ_{y < k} y² = (k - 1) k (2k - 1) / 6
+    auto squares = [](double k) {
+        return (k - 1.0) * k * (2.0 * k - 1.0) / 6.0;
+    };
+    double z = z_sum[base + y1 + 1] - z_sum[base + y0];
+    double y_sum = (static_cast<double>(y0) + y1) * m / 2.0;
+    moments.n = m;
+    moments.sx = m * x;
+    moments.sy = y_sum;
+    moments.sz = z;
+    moments.sxx = m * x * x;
+    moments.syy = squares(y1 + 1.0) - squares(y0);
+    moments.sxy = x * y_sum;
+    moments.sxz = x * z;
+    moments.syz = yz_sum[base + y1 + 1] - yz_sum[base + y0];
+    moments.invalid = bad_sum[base + y1 + 1] - bad_sum[base + y0];
+    return moments;
+}
+
+bool HeightSums::empty() const {
+    return z_sum.empty();
+}
@@ -0,0 +1,248 @@
+#include "ground/sampler.hpp"
+
+/**
+ * @brief 批量插值每组的点数，组内的权重与取数结果放在栈上
+ */
+static constexpr int sample_chunk = 64;
+
+HeightSampler::HeightSampler(): graph(nullptr), blocked(nullptr) {}
+
+HeightSampler::HeightSampler(const SqPlain& graph, const Bitmap& blocked): graph(&graph), blocked(&blocked) {}
+
+/**
+ * @brief 直接取位图中的位，调用者保证坐标在范围内
+ */
+inline double HeightSampler::bad(int x, int y) const {
+    size_t stride = (static_cast<size_t>(blocked->cols()) + 63) / 64;
+    return static_cast<double>((blocked->data()[static_cast<size_t>(x) * stride + (y >> 6)] >> (y & 63)) & 1);
+}
+
+inline double HeightSampler::height(int x, int y) const {
+    return bad(x, y) == 0.0 ? (*graph)[x][y] : 0.0;
+}
+
+/**
+ * @brief 把坐标截断到[0, upper]，NaN截断为0
+ */
+static inline double clamp_coord(double value, double upper) {
+    return value > 0.0 ? (value < upper ? value : upper) : 0.0;
+}
+
+/**
+ * @brief 坐标在[0, top] × [0, right]内时为1，否则（含NaN）为0
+ */
+static inline double inside_coord(double x, double y, double top, double right) {
+    return x >= 0.0 && x <= top && y >= 0.0 && y <= right ? 1.0 : 0.0;
+}
+
+/**
+ * @brief 双线性插值
+ *
+ * 坐标先截断到地图范围内再取格子，越界与障碍只影响最后的选择，不产生分支；
+ * 权重为0的障碍格子不影响结果
+ */
+void HeightSampler::bilinear(const double* x, const double* y, int count, double* out) const {
+    int row_count = rows();
+    int col_count = cols();
+    double top = row_count - 1;
+    double right = col_count - 1;
+    int last_x = std::max(row_count - 2, 0);
+    int last_y = std::max(col_count - 2, 0);
+
+    int x0[sample_chunk], y0[sample_chunk], x1[sample_chunk], y1[sample_chunk];
+    double fx[sample_chunk], fy[sample_chunk], keep[sample_chunk];
+    double h[4][sample_chunk], b[4][sample_chunk];
+    for (int base = 0; base < count; base += sample_chunk) {
+        int n = std::min(sample_chunk, count - base);
+        const double* px = x + base;
+        const double* py = y + base;
+
+        for (int i = 0; i < n; i++) {
+            double xc = clamp_coord(px[i], top);
+            double yc = clamp_coord(py[i], right);
+            x0[i] = std::min(static_cast<int>(xc), last_x);
+            y0[i] = std::min(static_cast<int>(yc), last_y);
+            x1[i] = std::min(x0[i] + 1, row_count - 1);
+            y1[i] = std::min(y0[i] + 1, col_count - 1);
+            fx[i] = xc - x0[i];
+            fy[i] = yc - y0[i];
+            keep[i] = inside_coord(px[i], py[i], top, right);
+        }
+
+        for (int i = 0; i < n; i++) {
+            h[0][i] = height(x0[i], y0[i]);
+            h[1][i] = height(x0[i], y1[i]);
+            h[2][i] = height(x1[i], y0[i]);
+            h[3][i] = height(x1[i], y1[i]);
+            b[0][i] = bad(x0[i], y0[i]);
+            b[1][i] = bad(x0[i], y1[i]);
+            b[2][i] = bad(x1[i], y0[i]);
+            b[3][i] = bad(x1[i], y1[i]);
+        }
+
+        for (int i = 0; i < n; i++) {
+            double w00 = (1.0 - fx[i]) * (1.0 - fy[i]);
+            double w01 = (1.0 - fx[i]) * fy[i];
+            double w10 = fx[i] * (1.0 - fy[i]);
+            double w11 = fx[i] * fy[i];
+            double value = w00 * h[0][i] + w01 * h[1][i] + w10 * h[2][i] + w11 * h[3][i];
+            double missing = w00 * b[0][i] + w01 * b[1][i] + w10 * b[2][i] + w11 * b[3][i];
+            out[base + i] = keep[i] != 0.0 && missing == 0.0 ? value : NAN;
+        }
+    }
+}
+
+/**
+ * @brief Catmull-Rom样条的四个权重，对应格子 c - 1, c, c + 1, c + 2
+ */
+static inline void catmull_rom(double t, double weight[4]) {
+    double t2 = t * t;
+    double t3 = t2 * t;
+    weight[0] = 0.5 * (-t3 + 2.0 * t2 - t);
+    weight[1] = 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0);
+    weight[2] = 0.5 * (-3.0 * t3 + 4.0 * t2 + t);
+    weight[3] = 0.5 * (t3 - t2);
+}
+
+/**
+ * @brief 双三次插值（Catmull-Rom）
+ *
+ * 4×4邻域中超出地图的格子取最近的边界格；权重不为0的格子中有障碍时结果为NaN
+ */
+void HeightSampler::bicubic(const double* x, const double* y, int count, double* out) const {
+    int row_count = rows();
+    int col_count = cols();
+    double top = row_count - 1;
+    double right = col_count - 1;
+
+    int row[4][sample_chunk], col[4][sample_chunk];
+    double wx[sample_chunk][4], wy[sample_chunk][4], keep[sample_chunk];
+    double h[16][sample_chunk], b[16][sample_chunk];
+    for (int base = 0; base < count; base += sample_chunk) {
+        int n = std::min(sample_chunk, count - base);
+        const double* px = x + base;
+        const double* py = y + base;
+
+        for (int i = 0; i < n; i++) {
+            double xc = clamp_coord(px[i], top);
+            double yc = clamp_coord(py[i], right);
+            int cx = static_cast<int>(xc);
+            int cy = static_cast<int>(yc);
+            catmull_rom(xc - cx, wx[i]);
+            catmull_rom(yc - cy, wy[i]);
+            for (int k = 0; k < 4; k++) {
+                row[k][i] = std::min(std::max(cx + k - 1, 0), row_count - 1);
+                col[k][i] = std::min(std::max(cy + k - 1, 0), col_count - 1);
+            }
+            keep[i] = inside_coord(px[i], py[i], top, right);
+        }
+
+        for (int k = 0; k < 16; k++) {
+            for (int i = 0; i < n; i++) {
+                h[k][i] = height(row[k / 4][i], col[k % 4][i]);
+                b[k][i] = bad(row[k / 4][i], col[k % 4][i]);
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            double value = 0.0;
+            double missing = 0.0;
+            for (int k = 0; k < 16; k++) {
+                double weight = wx[i][k / 4] * wy[i][k % 4];
+                value += weight * h[k][i];
+                missing += std::abs(weight) * b[k][i];
+            }
+            out[base + i] = keep[i] != 0.0 && missing == 0.0 ? value : NAN;
+        }
+    }
+}
+
+void HeightSampler::nearest(const double* x, const double* y, int count, double* out) const {
+    double top = rows() - 1;
+    double right = cols() - 1;
+
+    int row[sample_chunk], col[sample_chunk];
+    double keep[sample_chunk], h[sample_chunk], b[sample_chunk];
+    for (int base = 0; base < count; base += sample_chunk) {
+        int n = std::min(sample_chunk, count - base);
+        const double* px = x + base;
+        const double* py = y + base;
+
+        for (int i = 0; i < n; i++) {
+            row[i] = static_cast<int>(std::lround(clamp_coord(px[i], top)));
+            col[i] = static_cast<int>(std::lround(clamp_coord(py[i], right)));
+            keep[i] = inside_coord(px[i], py[i], top, right);
+        }
+
+        for (int i = 0; i < n; i++) {
+            h[i] = height(row[i], col[i]);
+            b[i] = bad(row[i], col[i]);
+        }
+
+        for (int i = 0; i < n; i++) {
+            out[base + i] = keep[i] != 0.0 && b[i] == 0.0 ? h[i] : NAN;
+        }
+    }
+}
+
+/**
+ * @brief 单点插值，与批量插值走同一条路径，结果逐位相同
+ */
+double HeightSampler::sample(double x, double y, Interpolation mode) const {
+    double out = NAN;
+    sample(&x, &y, 1, &out, mode);
+    return out;
+}
+
+/**
+ * @brief 批量插值
+ *
+ * 插值方式在循环外选定，每组点依次做权重、取数、合成三遍
+ *
+ * @param x 各点x坐标
+ * @param y 各点y坐标
+ * @param count 点数
+ * @param out 输出高度，无效点为NaN
+ * @param mode 插值方式
+ * @return 有效点数
+ */
+int HeightSampler::sample(const double* x, const double* y, int count, double* out, Interpolation mode) const {
+    if (empty()) {
+        std::fill(out, out + std::max(count, 0), NAN);
+        return 0;
+    }
+    switch (mode) {
+        case Interpolation::Nearest:
+            nearest(x, y, count, out);
+            break;
+        case Interpolation::Bicubic:
+            bicubic(x, y, count, out);
+            break;
+        default:
+            bilinear(x, y, count, out);
+            break;
+    }
+    int valid = 0;
+    for (int i = 0; i < count; i++) {
+        valid += out[i] == out[i] ? 1 : 0;
+    }
+    return valid;
+}
+
+int HeightSampler::sample(PointBatch& points, Interpolation mode) const {
+    points.z.resize(points.x.size());
+    return sample(points.x.data(), points.y.data(), points.size(), points.z.data(), mode);
+}
+
+int HeightSampler::rows() const {
+    return graph == nullptr ? 0 : graph->rows();
+}
+
+int HeightSampler::cols() const {
+    return graph == nullptr ? 0 : graph->cols();
+}
+
+bool HeightSampler::empty() const {
+    return graph == nullptr || blocked == nullptr || rows() == 0 || cols() == 0 ||
+           blocked->rows() != rows() || blocked->cols() != cols();
+}
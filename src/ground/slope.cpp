@@ -0,0 +1,167 @@
+#include "ground/slope.hpp"
+
+SlopeMap::SlopeMap(): row_count(0), col_count(0) {}
+
+/**
+ * @brief 构造函数，按行并行计算全图梯度
+ *
+ * @param graph 二维地图对象
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ */
+SlopeMap::SlopeMap(const SqPlain& graph, int threads): row_count(graph.rows()), col_count(graph.cols()) {
+    cell_x.assign(static_cast<size_t>(row_count) * col_count, 0.0f);
+    cell_y.assign(cell_x.size(), 0.0f);
+    sum_x.assign(static_cast<size_t>(row_count) * (col_count + 1), 0.0);
+    sum_y.assign(sum_x.size(), 0.0);
+    bad.assign(sum_x.size(), 0);
+    parallel_for(0, row_count, [&](int lo, int hi) {
+        for (int x = lo; x < hi; x++) {
+            build(graph, x);
+        }
+    }, threads);
+}
+
+/**
+ * @brief 求单个格子的梯度
+ *
+ * 障碍格子（graph.edge_allowed为false，即高度为负或无穷大）不参与拟合，本身也无法拟合；
+ * 邻域完整且都不是障碍时，最小二乘斜率化为Prewitt算子：
+ * a = (下一行之和 - 上一行之和) / 6，b = (右一列之和 - 左一列之和) / 6；
+ * 在边界或邻域含障碍时退回对非障碍邻格的一般最小二乘
+ *
+ * @return 格子是障碍或有效邻格不足以拟合时返回false
+ */
+bool SlopeMap::fit(const SqPlain& graph, int x, int y, double& a, double& b) const {
+    if (!graph.edge_allowed(Intex(x, y))) {
+        return false;
+    }
+    bool interior = x > 0 && x + 1 < row_count && y > 0 && y + 1 < col_count;
+    for (int nx = x - 1; interior && nx <= x + 1; nx++) {
+        for (int ny = y - 1; interior && ny <= y + 1; ny++) {
+            interior = graph.edge_allowed(Intex(nx, ny));
+        }
+    }
+    if (interior) {
+        const auto& up = graph[x - 1];
+        const auto& mid = graph[x];
+        const auto& down = graph[x + 1];
+        double dx = (down[y - 1] + down[y] + down[y + 1]) - (up[y - 1] + up[y] + up[y + 1]);
+        double dy = (up[y + 1] + mid[y + 1] + down[y + 1]) - (up[y - 1] + mid[y - 1] + down[y - 1]);
+        // 中心列与中心行不参与斜率，只用于判断整个邻域的高度是否有限
+        double rest = mid[y] + up[y] + down[y] + mid[y - 1] + mid[y + 1];
+        if (std::isfinite(dx) && std::isfinite(dy) && std::isfinite(rest)) {
+            a = dx / 6.0;
+            b = dy / 6.0;
+            return true;
+        }
+    }
+
+    PlaneMoments moments;
+    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, row_count - 1); nx++) {
+        for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, col_count - 1); ny++) {
+            if (graph.edge_allowed(Intex(nx, ny)) && std::isfinite(graph[nx][ny])) {
+                moments.add(nx - x, ny - y, graph[nx][ny]);
+            }
+        }
+    }
+    CuPlain plane = moments.fit();
+    if (plane.C == 0.0) {
+        return false;
+    }
+    a = -plane.A;
+    b = -plane.B;
+    return true;
+}
+
+/**
+ * @brief 重新计算第x行的单格梯度与梯度前缀和
+ */
+void SlopeMap::build(const SqPlain& graph, int x) {
+    size_t base = static_cast<size_t>(x) * (col_count + 1);
+    size_t row = static_cast<size_t>(x) * col_count;
+    for (int y = 0; y < col_count; y++) {
+        double a = 0.0;
+        double b = 0.0;
+        bool valid = fit(graph, x, y, a, b);
+        cell_x[row + y] = valid ? static_cast<float>(a) : NAN;
+        cell_y[row + y] = valid ? static_cast<float>(b) : NAN;
+        sum_x[base + y + 1] = sum_x[base + y] + (valid ? a : 0.0);
+        sum_y[base + y + 1] = sum_y[base + y] + (valid ? b : 0.0);
+        bad[base + y + 1] = bad[base + y] + (valid ? 0 : 1);
+    }
+}
+
+/**
+ * @brief 读取单格梯度
+ *
+ * 直接读逐格保存的值，不用前缀和之差，行末的格子也不会因相消丢失精度
+ *
+ * @return 格子越界或无法拟合时返回false
+ */
+bool SlopeMap::gradient(const Intex& cell, double& a, double& b) const {
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return false;
+    }
+    size_t id = static_cast<size_t>(cell.x) * col_count + cell.y;
+    if (std::isnan(cell_x[id])) {
+        return false;
+    }
+    a = cell_x[id];
+    b = cell_y[id];
+    return true;
+}
+
+void SlopeMap::update(const SqPlain& graph, const Intex& cell) {
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return;
+    }
+    for (int x = std::max(cell.x - 1, 0); x <= std::min(cell.x + 1, row_count - 1); x++) {
+        build(graph, x);
+    }
+}
+
+CuDot SlopeMap::normal(const Intex& cell) const {
+    double a = 0.0;
+    double b = 0.0;
+    if (!gradient(cell, a, b)) {
+        return CuDot();
+    }
+    double norm = std::sqrt(a * a + b * b + 1.0);
+    return CuDot(-a / norm, -b / norm, 1.0 / norm);
+}
+
+double SlopeMap::angle(const Intex& cell) const {
+    double a = 0.0;
+    double b = 0.0;
+    if (!gradient(cell, a, b)) {
+        return INFINITY;
+    }
+    return std::atan(std::hypot(a, b));
+}
+
+double SlopeMap::mean_angle(const FootSpan* spans, int count) const {
+    double gx = 0.0;
+    double gy = 0.0;
+    int cells = 0;
+    for (int k = 0; k < count; k++) {
+        const FootSpan& span = spans[k];
+        if (span.x < 0 || span.x >= row_count || span.y0 < 0 || span.y1 >= col_count) {
+            return INFINITY;
+        }
+        size_t base = static_cast<size_t>(span.x) * (col_count + 1);
+        if (bad[base + span.y1 + 1] != bad[base + span.y0]) {
+            return INFINITY;
+        }
+        gx += sum_x[base + span.y1 + 1] - sum_x[base + span.y0];
+        gy += sum_y[base + span.y1 + 1] - sum_y[base + span.y0];
+        cells += span.y1 - span.y0 + 1;
+    }
+    if (cells == 0) {
+        return INFINITY;
+    }
+    return std::atan(std::hypot(gx / cells, gy / cells));
+}
+
+bool SlopeMap::empty() const {
+    return bad.empty();
+}
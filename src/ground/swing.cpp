@@ -0,0 +1,216 @@
+#include "ground/swing.hpp"
+
+SwingTable::SwingTable(): row_count(0), col_count(0), levels(0) {}
+
+/**
+ * @brief 向上取整到float，取最大值与取整可交换，查表结果等于真实最大值向上取整
+ */
+static float round_up(double value) {
+    if (value > std::numeric_limits<float>::max()) {
+        return std::numeric_limits<float>::infinity();
+    }
+    float stored = static_cast<float>(value);
+    return stored < value ? std::nextafter(stored, std::numeric_limits<float>::infinity()) : stored;
+}
+
+/**
+ * @brief 格子在表中的高度，不可通行时为无穷大
+ */
+static float cell_height(const SqPlain& graph, const Intex& cell) {
+    return graph.edge_allowed(cell) ? round_up(graph[cell.x][cell.y]) : std::numeric_limits<float>::infinity();
+}
+
+/**
+ * @brief 构造函数，按行、按列并行建表
+ *
+ * @param graph 二维地图对象
+ * @param reach 单次查表覆盖的区间长度上限，表的层数取到不小于reach的2的幂，更长的区间分段查表；
+ *              每层按行、按列各占每格4字节
+ * @param threads 线程数，不大于0时使用hardware_threads()
+ */
+SwingTable::SwingTable(const SqPlain& graph, int reach, int threads):
+    row_count(graph.rows()), col_count(graph.cols()), levels(1) {
+
+    int longest = std::max(std::min(reach, std::max(row_count, col_count)), 1);
+    while ((1 << (levels - 1)) < longest) {
+        levels++;
+    }
+    size_t cells = static_cast<size_t>(row_count) * col_count;
+    by_row.assign(levels * cells, -std::numeric_limits<float>::infinity());
+    by_col.assign(levels * cells, -std::numeric_limits<float>::infinity());
+    for (int x = 0; x < row_count; x++) {
+        for (int y = 0; y < col_count; y++) {
+            float value = cell_height(graph, Intex(x, y));
+            by_row[static_cast<size_t>(x) * col_count + y] = value;
+            by_col[static_cast<size_t>(y) * row_count + x] = value;
+        }
+    }
+    parallel_for(0, row_count, [&](int lo, int hi) {
+        for (int x = lo; x < hi; x++) {
+            build_row(x);
+        }
+    }, threads);
+    parallel_for(0, col_count, [&](int lo, int hi) {
+        for (int y = lo; y < hi; y++) {
+            build_col(y);
+        }
+    }, threads);
+}
+
+void SwingTable::build_row(int x) {
+    size_t cells = static_cast<size_t>(row_count) * col_count;
+    for (int k = 1; k < levels; k++) {
+        int half = 1 << (k - 1);
+        const float* below = by_row.data() + (k - 1) * cells + static_cast<size_t>(x) * col_count;
+        float* level = by_row.data() + k * cells + static_cast<size_t>(x) * col_count;
+        for (int y = 0; y < col_count; y++) {
+            level[y] = y + half < col_count ? std::max(below[y], below[y + half]) : below[y];
+        }
+    }
+}
+
+void SwingTable::build_col(int y) {
+    size_t cells = static_cast<size_t>(row_count) * col_count;
+    for (int k = 1; k < levels; k++) {
+        int half = 1 << (k - 1);
+        const float* below = by_col.data() + (k - 1) * cells + static_cast<size_t>(y) * row_count;
+        float* level = by_col.data() + k * cells + static_cast<size_t>(y) * row_count;
+        for (int x = 0; x < row_count; x++) {
+            level[x] = x + half < row_count ? std::max(below[x], below[x + half]) : below[x];
+        }
+    }
+}
+
+void SwingTable::update(const SqPlain& graph, const Intex& cell) {
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return;
+    }
+    float value = cell_height(graph, cell);
+    by_row[static_cast<size_t>(cell.x) * col_count + cell.y] = value;
+    by_col[static_cast<size_t>(cell.y) * row_count + cell.x] = value;
+    build_row(cell.x);
+    build_col(cell.y);
+}
+
+double SwingTable::height(const Intex& cell) const {
+    if (cell.x < 0 || cell.x >= row_count || cell.y < 0 || cell.y >= col_count) {
+        return NAN;
+    }
+    return by_row[static_cast<size_t>(cell.x) * col_count + cell.y];
+}
+
+/**
+ * @brief 在一行（或一列）的稀疏表上查询[lo, hi]的最大值
+ *
+ * 取不超过区间长度的最高一层，区间不长于该层两倍时两次查表即可，
+ * 否则按该层的跨度分段，最后一段与前一段重叠
+ */
+double SwingTable::range_max(const std::vector<float>& table, size_t offset, int lo, int hi) const {
+    int length = hi - lo + 1;
+    int k = 0;
+    while (k + 1 < levels && (2 << k) <= length) {
+        k++;
+    }
+    int span = 1 << k;
+    const float* level = table.data() + k * static_cast<size_t>(row_count) * col_count + offset;
+    float best = -std::numeric_limits<float>::infinity();
+    for (int at = lo;; at += span) {
+        if (at + span - 1 >= hi) {
+            best = std::max(best, level[hi - span + 1]);
+            break;
+        }
+        best = std::max(best, level[at]);
+    }
+    return best;
+}
+
+double SwingTable::row_max(int x, int y0, int y1) const {
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, col_count - 1);
+    if (x < 0 || x >= row_count || y0 > y1) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    return range_max(by_row, static_cast<size_t>(x) * col_count, y0, y1);
+}
+
+double SwingTable::col_max(int y, int x0, int x1) const {
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, row_count - 1);
+    if (y < 0 || y >= col_count || x0 > x1) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    return range_max(by_col, static_cast<size_t>(y) * row_count, x0, x1);
+}
+
+/**
+ * @brief 线段在第a条带（主轴坐标为a）内覆盖的副轴格子区间
+ *
+ * 与Bitmap::sight的按行拆分相同，主轴可以是行也可以是列
+ */
+static void strip_cover(int a, int from_a, int to_a, int from_b, int to_b, int& b0, int& b1) {
+    const double eps = 1e-9;
+    double da = to_a - from_a;
+    double db = to_b - from_b;
+    double t0 = 0.0;
+    double t1 = 1.0;
+    if (da != 0.0) {
+        t0 = (a - 0.5 - from_a) / da;
+        t1 = (a + 0.5 - from_a) / da;
+        if (t0 > t1) std::swap(t0, t1);
+        t0 = std::max(t0, 0.0);
+        t1 = std::min(t1, 1.0);
+    }
+    double ba = from_b + t0 * db;
+    double bb = from_b + t1 * db;
+    if (ba > bb) std::swap(ba, bb);
+    b0 = static_cast<int>(std::ceil(ba - 0.5 + eps));
+    b1 = static_cast<int>(std::floor(bb + 0.5 - eps));
+}
+
+/**
+ * @brief 两格子中心连线经过的格子的最大高度
+ *
+ * 线段沿跨度较小的坐标轴拆分：行差不大于列差时逐行查行表，否则逐列查列表，
+ * 查表次数为min(|dx|, |dy|) + 1，每次查表的代价与区间长度无关（不超过reach时）
+ *
+ * @param from 起点格子
+ * @param to 终点格子
+ * @return 最大高度，端点越界时为无穷大
+ */
+double SwingTable::segment_max(const Intex& from, const Intex& to) const {
+    if (from.x < 0 || from.x >= row_count || from.y < 0 || from.y >= col_count ||
+        to.x < 0 || to.x >= row_count || to.y < 0 || to.y >= col_count) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double best = -std::numeric_limits<double>::infinity();
+    int b0 = 0;
+    int b1 = 0;
+    if (std::abs(to.x - from.x) <= std::abs(to.y - from.y)) {
+        for (int x = std::min(from.x, to.x); x <= std::max(from.x, to.x); x++) {
+            strip_cover(x, from.x, to.x, from.y, to.y, b0, b1);
+            best = std::max(best, row_max(x, b0, b1));
+        }
+    } else {
+        for (int y = std::min(from.y, to.y); y <= std::max(from.y, to.y); y++) {
+            strip_cover(y, from.y, to.y, from.x, to.x, b0, b1);
+            best = std::max(best, col_max(y, b0, b1));
+        }
+    }
+    return best;
+}
+
+bool SwingTable::clears(const Intex& from, const Intex& to, double height) const {
+    return segment_max(from, to) <= height;
+}
+
+int SwingTable::rows() const {
+    return row_count;
+}
+
+int SwingTable::cols() const {
+    return col_count;
+}
+
+bool SwingTable::empty() const {
+    return by_row.empty();
+}
@@ -34,117 +34,203 @@ bool FootShape::inside(double l_side, double w_side) {
     }
 }
 
+/**
+ * @brief 按坡度估计从小到大排列候选，候选最多8个，插入排序即可
+ */
+static void rank_guesses(std::array<std::pair<double, int>, 8>& ranked, int count) {
+    for (int i = 1; i < count; i++) {
+        std::pair<double, int> item = ranked[i];
+        int j = i - 1;
+        while (j >= 0 && item < ranked[j]) {
+            ranked[j + 1] = ranked[j];
+            j--;
+        }
+        ranked[j + 1] = item;
+    }
+}
+
+/**
+ * @brief 在半径radius的圆盘内做带记忆的坡度下降
+ * 
+ * 从起点出发，每步把8个邻居按坡度估计从小到大排序，只对估计最小的一个做精确拟合，更平就移动过去；
+ * 下降没有离开起点时改看fallback中的候选，只精确拟合坡度估计最小的三个；
+ * 同一次查询内每个偏移最多拟合一次，结果不劣于起点
+ * 
+ * @param radius 最大平移距离（格），只限制下降的步进，不限制fallback
+ * @param fallback 下降没有离开起点时才比较的候选偏移，最多8个
+ * @param estimate 偏移处的坡度估计，不可落足时为无穷大
+ * @param exact 偏移处的精确倾角，不可落足时为无穷大，不能返回NaN
+ * @param best 最终位置的倾角
+ * @param fits 精确拟合次数
+ * @return 最终位置相对起点的偏移
+ */
+template <typename Estimate, typename Exact>
+static Intex descend(int radius, const std::vector<Intex>& fallback, Estimate estimate, Exact exact, double& best, int& fits) {
+    static const int dx[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    static const int dy[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+    const int tries = 1;
+    const int fallback_tries = 3;
+
+    radius = std::max(radius, 0);
+    int extent = radius;
+    for (const auto& offset : fallback) {
+        extent = std::max(extent, std::max(std::abs(offset.x), std::abs(offset.y)));
+    }
+    int side = 2 * extent + 1;
+    std::vector<double> memo(static_cast<size_t>(side) * side, NAN);
+    fits = 0;
+    auto measure = [&](const Intex& offset) {
+        double& value = memo[static_cast<size_t>(offset.x + extent) * side + offset.y + extent];
+        if (std::isnan(value)) {
+            value = exact(offset);
+            fits++;
+        }
+        return value;
+    };
+
+    Intex at(0, 0);
+    best = measure(at);
+    std::array<std::pair<double, int>, 8> ranked;
+    for (int step = 0; step < side * side; step++) {
+        int count = 0;
+        for (int d = 0; d < 8; d++) {
+            Intex next(at.x + dx[d], at.y + dy[d]);
+            if (next.x * next.x + next.y * next.y > radius * radius) {
+                continue;
+            }
+            double guess = estimate(next);
+            if (std::isfinite(guess)) {
+                ranked[count++] = {guess, d};
+            }
+        }
+        rank_guesses(ranked, count);
+
+        bool moved = false;
+        for (int k = 0; k < std::min(count, tries) && !moved; k++) {
+            Intex next(at.x + dx[ranked[k].second], at.y + dy[ranked[k].second]);
+            double value = measure(next);
+            if (value < best) {
+                best = value;
+                at = next;
+                moved = true;
+            }
+        }
+        if (!moved) {
+            break;
+        }
+    }
+    if (at != Intex(0, 0)) {
+        return at;
+    }
+
+    int count = 0;
+    for (int k = 0; k < static_cast<int>(std::min<size_t>(fallback.size(), ranked.size())); k++) {
+        double guess = estimate(fallback[k]);
+        if (std::isfinite(guess)) {
+            ranked[count++] = {guess, k};
+        }
+    }
+    rank_guesses(ranked, count);
+    for (int k = 0; k < std::min(count, fallback_tries); k++) {
+        const Intex& next = fallback[ranked[k].second];
+        double value = measure(next);
+        if (value < best) {
+            best = value;
+            at = next;
+        }
+    }
+    return at;
+}
+
 /**
  * @brief 滑动调整足部落足区域以提高稳定性
  * 
- * 根据地面法向量调整足部的落足区域，以获得更好的稳定性
+ * 整体平移落足区域：在radius范围内做坡度下降，坡度估计取区域内各格法向量的平均方向，
+ * 只在最有希望的方向上用stand_angle重新拟合；下降没有找到更平的位置时，
+ * 再看沿拟合平面法向量水平分量正反平移1至3倍的位置，只拟合其中坡度估计最小的三个
  * 
  * @param area 足部落足区域
  * @param ground 地形对象
+ * @param radius 最大平移距离（格）
+ * @param fits 精确拟合次数
  * @return 滑动调整结果
  */
-SlideResult FootShape::slide(std::vector<SqDot>& area, Ground& ground) {
+SlideResult FootShape::slide(std::vector<SqDot>& area, const Ground& ground, int radius, int& fits) {
 
     auto shape = ground.shape();
     int rows = shape[0];
     int cols = shape[1];
-    
 
+    fits = 0;
     if (rows <= 0 || cols <= 0) {
         return SlideResult::NotApplicable;
     }
-    
-
-    auto normal = ground.normal(area);
-    
-
-    SqDot slide_vector = normal.slide();
-    
-
-    if (slide_vector.x == 0 && slide_vector.y == 0) {
+    if (area.empty()) {
         return SlideResult::NoModification;
     }
-    
-
-    double original_angle = ground.stand_angle(area);
-    
 
-    SqDot best_slide_vector = slide_vector;
-    double best_angle = original_angle;
-    std::vector<SqDot> best_area = area;
-    bool found_better = false;
-    
-
-    const int max_iterations = 3;
-    for (int i = 1; i <= max_iterations; i++) {
-        std::vector<SqDot> new_area;
-        bool all_points_valid = true;
-        
-        for (const auto& point : area) {
-            int new_x = point.x + slide_vector.x * i;
-            int new_y = point.y + slide_vector.y * i;
-            
+    const SlopeMap& slopes = ground.slope();
+    std::vector<SqDot> shifted(area.size());
+    auto shift = [&](const Intex& offset) {
+        for (size_t i = 0; i < area.size(); i++) {
+            int new_x = area[i].x_index() + offset.x;
+            int new_y = area[i].y_index() + offset.y;
             if (new_x < 0 || new_x >= rows || new_y < 0 || new_y >= cols) {
-                all_points_valid = false;
-                break;
-            }
-            
-            new_area.emplace_back(SqDot(new_x, new_y));
-        }
-        
-        if (all_points_valid) {
-            double new_angle = ground.stand_angle(new_area);
-            
-            if (new_angle < best_angle) {
-                best_angle = new_angle;
-                best_area = std::move(new_area);
-                found_better = true;
+                return false;
             }
+            shifted[i] = SqDot(new_x, new_y);
         }
-    }
-    
-
-    if (found_better) {
-        area = std::move(best_area);
-        return SlideResult::Modified;
-    }
-    
-
-    SqDot reverse_slide_vector(-slide_vector.x, -slide_vector.y);
-    for (int i = 1; i <= max_iterations; i++) {
-        std::vector<SqDot> new_area;
-        bool all_points_valid = true;
-        
+        return true;
+    };
+    auto estimate = [&](const Intex& offset) {
+        double sum_x = 0.0;
+        double sum_y = 0.0;
+        double sum_z = 0.0;
         for (const auto& point : area) {
-            int new_x = point.x + reverse_slide_vector.x * i;
-            int new_y = point.y + reverse_slide_vector.y * i;
-            
-            if (new_x < 0 || new_x >= rows || new_y < 0 || new_y >= cols) {
-                all_points_valid = false;
-                break;
+            CuDot normal = slopes.normal(Intex(point.x_index() + offset.x, point.y_index() + offset.y));
+            if (normal.z <= 0.0) {
+                return static_cast<double>(INFINITY);
             }
-            
-            new_area.emplace_back(SqDot(new_x, new_y));
+            sum_x += normal.x;
+            sum_y += normal.y;
+            sum_z += normal.z;
+        }
+        return std::atan2(std::hypot(sum_x, sum_y), sum_z);
+    };
+    auto exact = [&](const Intex& offset) {
+        if (!shift(offset)) {
+            return static_cast<double>(INFINITY);
         }
-        
-        if (all_points_valid) {
-            double new_angle = ground.stand_angle(new_area);
-            
-            if (new_angle < best_angle) {
-                best_angle = new_angle;
-                best_area = std::move(new_area);
-                found_better = true;
+        // 迭代拟合得到的法向量可能朝下，取平面与水平面的夹角
+        double angle = ground.stand_angle(shifted);
+        return std::isnan(angle) ? static_cast<double>(INFINITY) : std::min(angle, M_PI - angle);
+    };
+
+    // 整数坐标加上平移量后按int截断，非负坐标上等于平移量向下取整
+    SqDot vector = ground.normal(area).slide();
+    std::vector<Intex> fallback;
+    for (int sign : {1, -1}) {
+        for (int i = 1; i <= 3 && std::isfinite(vector.x) && std::isfinite(vector.y); i++) {
+            Intex offset(static_cast<int>(std::floor(sign * vector.x * i)), static_cast<int>(std::floor(sign * vector.y * i)));
+            if (offset != Intex(0, 0)) {
+                fallback.push_back(offset);
             }
         }
     }
-    
 
-    if (found_better) {
-        area = std::move(best_area);
-        return SlideResult::Modified;
+    double best = INFINITY;
+    Intex offset = descend(radius, fallback, estimate, exact, best, fits);
+    if (offset == Intex(0, 0)) {
+        return SlideResult::NoModification;
     }
-    
-    return SlideResult::NoModification;
+    shift(offset);
+    area = shifted;
+    return SlideResult::Modified;
+}
+
+SlideResult FootShape::slide(std::vector<SqDot>& area, const Ground& ground, int radius) {
+    int fits = 0;
+    return slide(area, ground, radius, fits);
 }
 
 /**
@@ -188,27 +274,53 @@ double Foot::direction_delta(const Foot& other) const {
     return other.rz - rz;
 }
 
+/**
+ * @brief 计算足部覆盖的格子
+ * 
+ * 由spans逐行给出与足部矩形有正面积重叠的格子，按行、列顺序展开；
+ * 超过footprint_rows行的足部改用按外接圆直径分配的堆缓冲区光栅化
+ * 
+ * @return 足部覆盖的点集合
+ */
 std::vector<SqDot> Foot::cover() const {
-        std::unordered_set<SqDot, SqDotHash> point_set{};
-    
-    auto half_length = shape.length / 2.0;
-    auto half_width = shape.width / 2.0;
-
-    double scan_step = 0.5; 
-    
-
-    for (double l = -half_length; l <= half_length; l += scan_step) {
-        for (double w = -half_width; w <= half_width; w += scan_step) {
-
-            double world_l = position.x + l * cos(rz) - w * sin(rz);
-            double world_w = position.y + l * sin(rz) + w * cos(rz);
-
-            point_set.insert(SqDot(round(world_l), round(world_w)));
+    FootSpan stack[footprint_rows];
+    std::vector<FootSpan> heap;
+    FootSpan* rows = stack;
+    int count = spans(rows, footprint_rows);
+    if (count < 0) {
+        heap.resize(static_cast<size_t>(std::ceil(std::hypot(shape.length, shape.width))) + 2);
+        rows = heap.data();
+        count = rasterize_foot(position.x, position.y, rz, shape.length, shape.width, rows, static_cast<int>(heap.size()));
+    }
+    std::vector<SqDot> points;
+    for (int k = 0; k < count; k++) {
+        for (int y = rows[k].y0; y <= rows[k].y1; y++) {
+            points.emplace_back(rows[k].x, y);
         }
     }
-    
+    return points;
+}
 
-    return std::vector<SqDot>(point_set.begin(), point_set.end());
+/**
+ * @brief 按行输出足部覆盖的格子，不分配内存
+ * 
+ * 中心在整数格子上且朝向落在共享模板缓存的量化朝向上时平移模板，
+ * 否则直接光栅化；两种方式在前一种情况下结果相同
+ * 
+ * @param out 输出缓冲区
+ * @param capacity 缓冲区容量
+ * @return 写入的行数，容量不足时返回-1
+ */
+int Foot::spans(FootSpan* out, int capacity) const {
+    if (position.x == std::floor(position.x) && position.y == std::floor(position.y) &&
+        StencilCache::shared().aligned(rz)) {
+        return stencil().place(Intex(position.x_index(), position.y_index()), out, capacity);
+    }
+    return rasterize_foot(position.x, position.y, rz, shape.length, shape.width, out, capacity);
+}
+
+const Stencil& Foot::stencil() const {
+    return StencilCache::shared().get(shape.length, shape.width, rz);
 }
 
 std::vector<SqDot> Foot::corner() const {
@@ -232,13 +344,117 @@ std::vector<SqDot> Foot::corner() const {
     return points;
 }
 
+/**
+ * @brief 足部矩形的包围盒是否在地图内，此时覆盖的格子都不越界
+ * 
+ * 覆盖的格子与矩形有正面积重叠，其中心与包围盒的距离小于半个格子
+ * 
+ * @param ground 地形对象
+ * @return 包围盒在[-0.5, rows - 0.5] x [-0.5, cols - 0.5]内时返回true
+ */
+bool Foot::inside(const Ground& ground) const {
+    auto points = corner();
+    auto [x_low, x_high] = std::minmax({points[0].x, points[1].x, points[2].x, points[3].x});
+    auto [y_low, y_high] = std::minmax({points[0].y, points[1].y, points[2].y, points[3].y});
+    return x_low >= -0.5 && x_high <= ground.rows() - 0.5 && y_low >= -0.5 && y_high <= ground.cols() - 0.5;
+}
+
+/**
+ * @brief 检查足部覆盖的格子到最近障碍的距离是否都不小于margin
+ * 
+ * 距离场是1-Lipschitz的，先用中心所在格子的距离判断：
+ * 中心本身不满足时直接拒绝；足部包围盒在地图内、且中心距离超过margin加外接圆半径再加√2时直接接受，
+ * 其中√2/2来自中心取整到格子，另√2/2来自覆盖格子的中心可以落在外接圆外半个格子对角线处；
+ * 其余情况逐格检查覆盖区域
+ * 
+ * @param ground 地形对象
+ * @param margin 最小距离
+ * @return 全部满足时返回true，足部中心越界时返回false
+ */
+bool Foot::clear(const Ground& ground, double margin) const {
+    if (!ground.is_valid(position)) {
+        return false;
+    }
+    const Clearance& room = ground.clearance();
+    double around = room.distance(Intex(position.x_index(), position.y_index()));
+    double reach = std::hypot(shape.length, shape.width) / 2.0 + M_SQRT2;
+    if (around < margin) {
+        return false;
+    }
+    if (around >= margin + reach && inside(ground)) {
+        return true;
+    }
+    FootSpan rows[footprint_rows];
+    int count = spans(rows, footprint_rows);
+    if (count < 0) {
+        return false;
+    }
+    for (int k = 0; k < count; k++) {
+        for (int y = rows[k].y0; y <= rows[k].y1; y++) {
+            if (!ground.is_valid(rows[k].x, y) || !room.clear(Intex(rows[k].x, y), margin)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 在radius范围内把足部中心移到拟合平面更平的格子
+ * 
+ * 平移整数格时覆盖区间只需整体平移，坡度估计由SlopeMap::mean_angle按行常数时间求得，
+ * 精确倾角由行前缀和拟合最小二乘平面
+ * 
+ * @param ground 地形对象
+ * @param radius 最大平移距离（格）
+ * @return 细化结果，找不到更平的位置时position为原位置
+ */
+SettleResult Foot::settle(const Ground& ground, int radius) const {
+    FootSpan base[footprint_rows];
+    int count = ground.empty() ? -1 : spans(base, footprint_rows);
+    if (count <= 0) {
+        return SettleResult{SlideResult::NotApplicable, position, INFINITY, 0};
+    }
+
+    FootSpan placed[footprint_rows];
+    auto place = [&](const Intex& offset) {
+        for (int k = 0; k < count; k++) {
+            placed[k] = FootSpan{base[k].x + offset.x, base[k].y0 + offset.y, base[k].y1 + offset.y};
+            if (!ground.is_valid(placed[k].x, placed[k].y0) || !ground.is_valid(placed[k].x, placed[k].y1) ||
+                ground.obstacles().any(placed[k].x, placed[k].y0, placed[k].y1)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto estimate = [&](const Intex& offset) {
+        return place(offset) ? ground.slope().mean_angle(placed, count) : static_cast<double>(INFINITY);
+    };
+    auto exact = [&](const Intex& offset) {
+        if (!place(offset)) {
+            return static_cast<double>(INFINITY);
+        }
+        CuPlain plane = ground.trip(placed, count);
+        double angle = plane.C == 0.0 ? NAN : plane.normal_angle();
+        return std::isnan(angle) ? static_cast<double>(INFINITY) : angle;
+    };
+
+    SettleResult settled{SlideResult::NoModification, position, INFINITY, 0};
+    Intex offset = descend(radius, {}, estimate, exact, settled.angle, settled.fits);
+    if (offset != Intex(0, 0)) {
+        settled.result = SlideResult::Modified;
+        settled.position = SqDot(position.x + offset.x, position.y + offset.y);
+    }
+    return settled;
+}
+
 /**
  * @brief 让足部走向指定位置
  * 
  * @param ground 地形对象
  * @return 如果成功走向指定位置返回true，否则返回false
  */
-bool Foot::walkto(Ground& ground) { 
+bool Foot::walkto(const Ground& ground) { 
 
     if (ground.empty()) {
         return false;
@@ -0,0 +1,162 @@
+#include "robot/footprint.hpp"
+
+namespace {
+
+/**
+ * @brief 判断区间重叠时忽略的容差，避免边界恰好落在格子边上时因舍入误差多算一格
+ */
+constexpr double overlap_eps = 1e-9;
+
+struct Corners {
+    double x[4];
+    double y[4];
+};
+
+Corners corners_of(double cx, double cy, double c, double s, double length, double width) {
+    double hl = length / 2.0;
+    double hw = width / 2.0;
+    const double ls[4] = {-hl, hl, hl, -hl};
+    const double ws[4] = {-hw, -hw, hw, hw};
+    Corners out{};
+    for (int k = 0; k < 4; k++) {
+        out.x[k] = cx + ls[k] * c - ws[k] * s;
+        out.y[k] = cy + ls[k] * s + ws[k] * c;
+    }
+    return out;
+}
+
+/**
+ * @brief 矩形在竖直条带 a <= x <= b 内部分的y范围
+ *
+ * @return 条带与矩形不相交时返回false
+ */
+bool slab_range(const Corners& box, double a, double b, double& low, double& high) {
+    low = INFINITY;
+    high = -INFINITY;
+    for (int k = 0; k < 4; k++) {
+        double x0 = box.x[k];
+        double y0 = box.y[k];
+        double x1 = box.x[(k + 1) % 4];
+        double y1 = box.y[(k + 1) % 4];
+        if (a <= x0 && x0 <= b) {
+            low = std::min(low, y0);
+            high = std::max(high, y0);
+        }
+        for (double edge : {a, b}) {
+            if ((x0 - edge) * (x1 - edge) < 0.0) {
+                double t = (edge - x0) / (x1 - x0);
+                double y = y0 + t * (y1 - y0);
+                low = std::min(low, y);
+                high = std::max(high, y);
+            }
+        }
+    }
+    return low <= high;
+}
+
+/**
+ * @brief 用半平面裁剪多边形，顶点数组就地更新
+ *
+ * 半平面为 sign * (axis坐标 - bound) <= 0
+ */
+int clip(double* px, double* py, int count, bool along_x, double bound, double sign) {
+    double qx[8];
+    double qy[8];
+    int out = 0;
+    for (int k = 0; k < count; k++) {
+        int n = (k + 1) % count;
+        double dk = sign * ((along_x ? px[k] : py[k]) - bound);
+        double dn = sign * ((along_x ? px[n] : py[n]) - bound);
+        if (dk <= 0.0) {
+            qx[out] = px[k];
+            qy[out] = py[k];
+            out++;
+        }
+        if ((dk < 0.0 && dn > 0.0) || (dk > 0.0 && dn < 0.0)) {
+            double t = dk / (dk - dn);
+            qx[out] = px[k] + t * (px[n] - px[k]);
+            qy[out] = py[k] + t * (py[n] - py[k]);
+            out++;
+        }
+    }
+    std::copy(qx, qx + out, px);
+    std::copy(qy, qy + out, py);
+    return out;
+}
+
+}
+
+/**
+ * @brief 精确光栅化旋转后的足部矩形
+ *
+ * 对每一行求矩形在该行条带内的y范围（条带内的角点与各边和条带边界的交点），
+ * 与该范围有正长度重叠的格子即为被覆盖的格子
+ *
+ * @param cx 足部中心x坐标
+ * @param cy 足部中心y坐标
+ * @param rz 足部朝向角（弧度）
+ * @param length 足部长度
+ * @param width 足部宽度
+ * @param spans 输出缓冲区
+ * @param capacity 缓冲区容量
+ * @return 写入的行数，容量不足时返回-1
+ */
+int rasterize_foot(double cx, double cy, double rz, double length, double width, FootSpan* spans, int capacity) {
+    if (length <= 0.0 || width <= 0.0) {
+        return 0;
+    }
+    Corners box = corners_of(cx, cy, std::cos(rz), std::sin(rz), length, width);
+    double xmin = *std::min_element(box.x, box.x + 4);
+    double xmax = *std::max_element(box.x, box.x + 4);
+    int first = static_cast<int>(std::floor(xmin - 0.5 + overlap_eps)) + 1;
+    int last = static_cast<int>(std::ceil(xmax + 0.5 - overlap_eps)) - 1;
+
+    int count = 0;
+    for (int x = first; x <= last; x++) {
+        double low;
+        double high;
+        if (!slab_range(box, x - 0.5, x + 0.5, low, high)) continue;
+        int y0 = static_cast<int>(std::floor(low - 0.5 + overlap_eps)) + 1;
+        int y1 = static_cast<int>(std::ceil(high + 0.5 - overlap_eps)) - 1;
+        if (y0 > y1) continue;
+        if (count >= capacity) {
+            return -1;
+        }
+        spans[count++] = {x, y0, y1};
+    }
+    return count;
+}
+
+/**
+ * @brief 计算rasterize_foot输出的每个格子被足部覆盖的面积比例
+ *
+ * 把矩形依次用格子的四条边裁剪，裁剪后多边形的面积即覆盖面积
+ */
+int foot_weights(double cx, double cy, double rz, double length, double width,
+                 const FootSpan* spans, int count, double* weights, int capacity) {
+    Corners box = corners_of(cx, cy, std::cos(rz), std::sin(rz), length, width);
+    int written = 0;
+    for (int k = 0; k < count; k++) {
+        for (int y = spans[k].y0; y <= spans[k].y1; y++) {
+            if (written >= capacity) {
+                return -1;
+            }
+            double px[8];
+            double py[8];
+            std::copy(box.x, box.x + 4, px);
+            std::copy(box.y, box.y + 4, py);
+            int n = 4;
+            n = clip(px, py, n, true, spans[k].x - 0.5, -1.0);
+            n = clip(px, py, n, true, spans[k].x + 0.5, 1.0);
+            n = clip(px, py, n, false, y - 0.5, -1.0);
+            n = clip(px, py, n, false, y + 0.5, 1.0);
+            double area = 0.0;
+            for (int v = 0; v < n; v++) {
+                int w = (v + 1) % n;
+                area += px[v] * py[w] - px[w] * py[v];
+            }
+            weights[written++] = std::min(1.0, std::abs(area) / 2.0);
+        }
+    }
+    return written;
+}
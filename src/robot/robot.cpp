@@ -210,6 +210,16 @@ bool Robot::satisfy_turn(const SqDot& new_pos) {
     return angle < max_turn && angle > - max_turn;
 }
 
+bool Robot::satisfy_swing(const SwingTable& table, const SqDot& new_pos, double lift) {
+    Intex from(get_swing_foot().position.x_index(), get_swing_foot().position.y_index());
+    Intex to(new_pos.x_index(), new_pos.y_index());
+    double apex = std::max(table.height(from), table.height(to));
+    if (!std::isfinite(apex)) {
+        return false;
+    }
+    return table.clears(from, to, apex + lift);
+}
+
 /**
  * @brief 滑动调整足部落足区域
  * 
@@ -219,7 +229,7 @@ bool Robot::satisfy_turn(const SqDot& new_pos) {
  * @param ground 地形对象
  * @return 滑动调整结果
  */
-SlideResult Robot::slide(std::vector<SqDot>& area, Ground& ground) { 
+SlideResult Robot::slide(std::vector<SqDot>& area, const Ground& ground) { 
     return get_swing_foot().shape.slide(area, ground);
 }
 
@@ -234,15 +244,99 @@ SqDot Robot::walk_with_guide(const Ground& ground, const SqDot& goal) {
     // TODO
 }
 
+/**
+ * @brief 在goal附近按距离由近到远查找第一个满足accept的格子
+ * 
+ * @param goal 原始目标点
+ * @param radius 查找半径
+ * @param accept 格子判断函数
+ * @param found 找到的格子
+ * @return 找到时返回true
+ */
+template <typename Accept>
+static bool nearest_cell(const SqDot& goal, double radius, Accept accept, SqDot& found) {
+    int reach = static_cast<int>(std::ceil(std::max(radius, 0.0)));
+    Intex centre(goal.x_index(), goal.y_index());
+    std::vector<std::pair<int, Intex>> offsets;
+    for (int dx = -reach; dx <= reach; dx++) {
+        for (int dy = -reach; dy <= reach; dy++) {
+            if (dx * dx + dy * dy <= radius * radius) {
+                offsets.emplace_back(dx * dx + dy * dy, Intex(dx, dy));
+            }
+        }
+    }
+    std::stable_sort(offsets.begin(), offsets.end(), [](const std::pair<int, Intex>& a, const std::pair<int, Intex>& b) {
+        return a.first < b.first;
+    });
+    for (const auto& offset : offsets) {
+        Intex cell(centre.x + offset.second.x, centre.y + offset.second.y);
+        if (accept(cell)) {
+            found = SqDot(cell.x, cell.y);
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief 调整目标点以适应地形约束
  * 
+ * 候选格子需满足足部覆盖区域在地图内、不压障碍且Ground::stand_check通过；
+ * 朝向按Footholds::quantize量化，模板取自StencilCache::shared(2 * headings)，
+ * 与可落足位图的朝向一致，每个候选格子只需平移同一个模板
+ * 
  * @param ground 地形对象
  * @param goal 原始目标点
- * @return 调整后的目标点
+ * @param headings 朝向量化数目
+ * @return 调整后的目标点，找不到时返回摆动脚当前位置
  */
-SqDot Robot::fit_target(const Ground& ground, const SqDot& goal) { 
-    // TODO
+SqDot Robot::fit_target(const Ground& ground, const SqDot& goal, int headings) { 
+    const Foot& support_foot = get_support_foot();
+    const Foot& swing_foot = get_swing_foot();
+    double rz = support_foot.position.distance(goal) > 0.0 ? support_foot.position.angle(goal) : support_foot.rz;
+    headings = std::max(headings, 1);
+    double quantized = Footholds::quantize(rz, headings) * M_PI / headings;
+
+    const Stencil& stencil = StencilCache::shared(2 * headings).get(swing_foot.shape.length, swing_foot.shape.width, quantized);
+
+    SqDot found = swing_foot.position;
+    nearest_cell(goal, max_foot_separation, [&](const Intex& cell) {
+        FootSpan spans[footprint_rows];
+        int count = stencil.place(cell, spans, footprint_rows);
+        if (count <= 0) {
+            return false;
+        }
+        for (int k = 0; k < count; k++) {
+            if (!ground.is_valid(spans[k].x, spans[k].y0) || !ground.is_valid(spans[k].x, spans[k].y1) ||
+                ground.obstacles().any(spans[k].x, spans[k].y0, spans[k].y1)) {
+                return false;
+            }
+        }
+        return ground.stand_check(spans, count);
+    }, found);
+    return found;
+}
+
+/**
+ * @brief 调整目标点以适应地形约束，落足判断查预计算的可落足位图
+ * 
+ * 与fit_target(ground, goal, footholds.headings())的查找顺序与朝向量化都相同，
+ * 每个候选格子只做一次位测试
+ * 
+ * @param footholds 按摆动脚尺寸构建的可落足位图
+ * @param goal 原始目标点
+ * @return 调整后的目标点，找不到时返回摆动脚当前位置
+ */
+SqDot Robot::fit_target(const Footholds& footholds, const SqDot& goal) { 
+    const Foot& support_foot = get_support_foot();
+    double rz = support_foot.position.distance(goal) > 0.0 ? support_foot.position.angle(goal) : support_foot.rz;
+    int heading = footholds.heading(rz);
+
+    SqDot found = get_swing_foot().position;
+    nearest_cell(goal, max_foot_separation, [&](const Intex& cell) {
+        return footholds.fits(cell, heading);
+    }, found);
+    return found;
 }
 
 /**
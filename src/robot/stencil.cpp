@@ -0,0 +1,115 @@
+#include "robot/stencil.hpp"
+
+std::vector<SqDot> Stencil::cover(const Intex& centre) const {
+    std::vector<SqDot> points;
+    points.reserve(cells.size());
+    for (const auto& cell : cells) {
+        points.emplace_back(centre.x + cell.x, centre.y + cell.y);
+    }
+    return points;
+}
+
+std::vector<SqDot> Stencil::corner(const SqDot& centre) const {
+    std::vector<SqDot> points;
+    points.reserve(corners.size());
+    for (const auto& offset : corners) {
+        points.emplace_back(centre.x + offset.x, centre.y + offset.y);
+    }
+    return points;
+}
+
+int Stencil::place(const Intex& centre, FootSpan* out, int capacity) const {
+    int count = static_cast<int>(spans.size());
+    if (oversized || count > capacity) {
+        return -1;
+    }
+    for (int k = 0; k < count; k++) {
+        out[k] = FootSpan{centre.x + spans[k].x, centre.y + spans[k].y0, centre.y + spans[k].y1};
+    }
+    return count;
+}
+
+bool StencilCache::Key::operator==(const Key& other) const {
+    return length == other.length && width == other.width && heading == other.heading;
+}
+
+size_t StencilCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = std::hash<double>()(key.length);
+    seed ^= std::hash<double>()(key.width) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<int>()(key.heading) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+StencilCache::StencilCache(int headings): bucket_count(std::max(headings, 1)) {}
+
+StencilCache& StencilCache::shared(int headings) {
+    static std::mutex registry_lock;
+    static std::map<int, std::unique_ptr<StencilCache>> registry;
+    headings = std::max(headings, 1);
+    std::lock_guard<std::mutex> guard(registry_lock);
+    auto& cache = registry[headings];
+    if (!cache) {
+        cache = std::make_unique<StencilCache>(headings);
+    }
+    return *cache;
+}
+
+int StencilCache::heading(double rz) const {
+    double step = 2.0 * M_PI / bucket_count;
+    int index = static_cast<int>(std::lround(rz / step)) % bucket_count;
+    return index < 0 ? index + bucket_count : index;
+}
+
+bool StencilCache::aligned(double rz) const {
+    double step = 2.0 * M_PI / bucket_count;
+    return std::abs(rz - std::round(rz / step) * step) <= 1e-12;
+}
+
+/**
+ * @brief 获取模板，不存在时创建
+ *
+ * 模板由rasterize_foot在原点生成，光栅化是平移不变的，
+ * 因此平移到任意整数格子后与该处直接光栅化的结果相同；
+ * 足部超过footprint_rows行时只记下oversized，调用者据此拒绝该落足点
+ *
+ * @param length 足部长度
+ * @param width 足部宽度
+ * @param rz 朝向角（弧度），取最近的量化朝向
+ * @return 模板
+ */
+const Stencil& StencilCache::get(double length, double width, double rz) {
+    Key key{length, width, heading(rz)};
+    std::lock_guard<std::mutex> guard(lock);
+    auto found = stencils.find(key);
+    if (found != stencils.end()) {
+        return *found->second;
+    }
+
+    auto stencil = std::make_unique<Stencil>();
+    stencil->rz = key.heading * 2.0 * M_PI / bucket_count;
+    FootSpan rows[footprint_rows];
+    int count = rasterize_foot(0.0, 0.0, stencil->rz, length, width, rows, footprint_rows);
+    stencil->oversized = count < 0;
+    for (int k = 0; k < count; k++) {
+        stencil->spans.push_back(rows[k]);
+        for (int y = rows[k].y0; y <= rows[k].y1; y++) {
+            stencil->cells.emplace_back(rows[k].x, y);
+        }
+    }
+
+    double l_cos = length / 2.0 * std::cos(stencil->rz);
+    double l_sin = length / 2.0 * std::sin(stencil->rz);
+    double w_cos = width / 2.0 * std::cos(stencil->rz);
+    double w_sin = width / 2.0 * std::sin(stencil->rz);
+    stencil->corners = {SqDot(l_cos - w_sin, l_sin + w_cos), SqDot(l_cos + w_sin, l_sin - w_cos),
+                        SqDot(-l_cos + w_sin, -l_sin - w_cos), SqDot(-l_cos - w_sin, -l_sin + w_cos)};
+
+    const Stencil& result = *stencil;
+    stencils.emplace(key, std::move(stencil));
+    return result;
+}
+
+size_t StencilCache::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return stencils.size();
+}
@@ -0,0 +1,195 @@
+#include "utils/batch.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+void PointBatch::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+void PointBatch::push(double px, double py, double pz) {
+    x.push_back(px);
+    y.push_back(py);
+    z.push_back(pz);
+}
+
+void PointBatch::push(const CuDot& dot) {
+    push(dot.x, dot.y, dot.z);
+}
+
+void PointBatch::erase(int index) {
+    x.erase(x.begin() + index);
+    y.erase(y.begin() + index);
+    z.erase(z.begin() + index);
+}
+
+int PointBatch::size() const {
+    return static_cast<int>(x.size());
+}
+
+bool PointBatch::empty() const {
+    return x.empty();
+}
+
+/**
+ * @brief 法向量长度的倒数，长度小于1e-9时为0
+ */
+static double inverse_norm(const CuPlain& plane) {
+    double norm = std::sqrt(plane.A * plane.A + plane.B * plane.B + plane.C * plane.C);
+    return norm < 1e-9 ? 0.0 : 1.0 / norm;
+}
+
+/**
+ * @brief 批量计算 A * x + B * y + C * z + D
+ *
+ * 向量部分与标量尾部的运算顺序相同，同一个点无论落在哪部分结果都一致
+ */
+static void plane_values(const CuPlain& plane, const double* x, const double* y, const double* z, int count, double* out) {
+    int i = 0;
+#if defined(__AVX2__)
+    __m256d a = _mm256_set1_pd(plane.A);
+    __m256d b = _mm256_set1_pd(plane.B);
+    __m256d c = _mm256_set1_pd(plane.C);
+    __m256d d = _mm256_set1_pd(plane.D);
+    for (; i + 4 <= count; i += 4) {
+        __m256d value = _mm256_add_pd(_mm256_mul_pd(a, _mm256_loadu_pd(x + i)), _mm256_mul_pd(b, _mm256_loadu_pd(y + i)));
+        value = _mm256_add_pd(_mm256_add_pd(value, _mm256_mul_pd(c, _mm256_loadu_pd(z + i))), d);
+        _mm256_storeu_pd(out + i, value);
+    }
+#elif defined(__SSE2__)
+    __m128d a = _mm_set1_pd(plane.A);
+    __m128d b = _mm_set1_pd(plane.B);
+    __m128d c = _mm_set1_pd(plane.C);
+    __m128d d = _mm_set1_pd(plane.D);
+    for (; i + 2 <= count; i += 2) {
+        __m128d value = _mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(x + i)), _mm_mul_pd(b, _mm_loadu_pd(y + i)));
+        value = _mm_add_pd(_mm_add_pd(value, _mm_mul_pd(c, _mm_loadu_pd(z + i))), d);
+        _mm_storeu_pd(out + i, value);
+    }
+#endif
+    for (; i < count; i++) {
+        double value = plane.A * x[i] + plane.B * y[i];
+        out[i] = (value + plane.C * z[i]) + plane.D;
+    }
+}
+
+void plane_distances(const CuPlain& plane, const double* x, const double* y, const double* z, int count, double* out) {
+    plane_values(plane, x, y, z, count, out);
+    double scale = inverse_norm(plane);
+    for (int i = 0; i < count; i++) {
+        out[i] *= scale;
+    }
+}
+
+void plane_distances(const CuPlain& plane, const PointBatch& points, double* out) {
+    plane_distances(plane, points.x.data(), points.y.data(), points.z.data(), points.size(), out);
+}
+
+void plane_sides(const CuPlain& plane, const double* x, const double* y, const double* z, int count, int8_t* out) {
+    thread_local std::vector<double> values;
+    values.resize(static_cast<size_t>(count));
+    plane_values(plane, x, y, z, count, values.data());
+    for (int i = 0; i < count; i++) {
+        out[i] = static_cast<int8_t>((values[i] > 1e-9) - (values[i] < -1e-9));
+    }
+}
+
+void plane_sides(const CuPlain& plane, const PointBatch& points, int8_t* out) {
+    plane_sides(plane, points.x.data(), points.y.data(), points.z.data(), points.size(), out);
+}
+
+/**
+ * @brief 点到平面距离（绝对值）之和
+ *
+ * 先累加|A * x + B * y + C * z + D|，最后乘一次法向量长度的倒数
+ */
+double plane_error(const CuPlain& plane, const double* x, const double* y, const double* z, int count) {
+    double scale = inverse_norm(plane);
+    if (scale == 0.0) {
+        return 0.0;
+    }
+
+    int i = 0;
+    double sum = 0.0;
+#if defined(__AVX2__)
+    __m256d a = _mm256_set1_pd(plane.A);
+    __m256d b = _mm256_set1_pd(plane.B);
+    __m256d c = _mm256_set1_pd(plane.C);
+    __m256d d = _mm256_set1_pd(plane.D);
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d total = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        __m256d value = _mm256_add_pd(_mm256_mul_pd(a, _mm256_loadu_pd(x + i)), _mm256_mul_pd(b, _mm256_loadu_pd(y + i)));
+        value = _mm256_add_pd(_mm256_add_pd(value, _mm256_mul_pd(c, _mm256_loadu_pd(z + i))), d);
+        total = _mm256_add_pd(total, _mm256_andnot_pd(sign, value));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, total);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(__SSE2__)
+    __m128d a = _mm_set1_pd(plane.A);
+    __m128d b = _mm_set1_pd(plane.B);
+    __m128d c = _mm_set1_pd(plane.C);
+    __m128d d = _mm_set1_pd(plane.D);
+    __m128d sign = _mm_set1_pd(-0.0);
+    __m128d total = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2) {
+        __m128d value = _mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(x + i)), _mm_mul_pd(b, _mm_loadu_pd(y + i)));
+        value = _mm_add_pd(_mm_add_pd(value, _mm_mul_pd(c, _mm_loadu_pd(z + i))), d);
+        total = _mm_add_pd(total, _mm_andnot_pd(sign, value));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, total);
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < count; i++) {
+        double value = plane.A * x[i] + plane.B * y[i];
+        sum += std::abs((value + plane.C * z[i]) + plane.D);
+    }
+    return sum * scale;
+}
+
+double plane_error(const CuPlain& plane, const PointBatch& points) {
+    return plane_error(plane, points.x.data(), points.y.data(), points.z.data(), points.size());
+}
+
+/**
+ * @brief 平面上方距离最大的点
+ *
+ * 上方的点满足 A * x + B * y + C * z + D > 1e-9，距离与该值成正比，直接比较该值即可
+ *
+ * @param plane 平面
+ * @param points 点集
+ * @param distance 该点到平面的距离
+ * @return 点的下标，多个点距离相同时取下标最小者，上方没有点时返回-1
+ */
+int farthest_above(const CuPlain& plane, const PointBatch& points, double& distance) {
+    distance = 0.0;
+    double scale = inverse_norm(plane);
+    if (scale == 0.0) {
+        return -1;
+    }
+
+    thread_local std::vector<double> values;
+    int count = points.size();
+    values.resize(static_cast<size_t>(count));
+    plane_values(plane, points.x.data(), points.y.data(), points.z.data(), count, values.data());
+
+    int best = -1;
+    double highest = 1e-9;
+    for (int i = 0; i < count; i++) {
+        if (values[i] > highest) {
+            highest = values[i];
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        distance = highest * scale;
+    }
+    return best;
+}
@@ -0,0 +1,142 @@
+#include "utils/bitmap.hpp"
+
+Bitmap::Bitmap(): row_count(0), col_count(0), stride(0) {}
+
+Bitmap::Bitmap(int rows, int cols):
+    row_count(std::max(rows, 0)), col_count(std::max(cols, 0)), stride((std::max(cols, 0) + 63) / 64),
+    words(static_cast<size_t>(std::max(rows, 0)) * ((std::max(cols, 0) + 63) / 64), 0) {}
+
+Bitmap::Bitmap(const SqPlain& graph): Bitmap(graph.rows(), graph.cols()) {
+    for (int x = 0; x < row_count; x++) {
+        for (int y = 0; y < col_count; y++) {
+            if (!graph.edge_allowed(Intex(x, y))) {
+                words[static_cast<size_t>(x) * stride + (y >> 6)] |= uint64_t(1) << (y & 63);
+            }
+        }
+    }
+}
+
+Bitmap::Bitmap(int rows, int cols, std::vector<uint64_t> words): Bitmap(rows, cols) {
+    if (words.size() == this->words.size()) {
+        this->words = std::move(words);
+    }
+}
+
+bool Bitmap::test(int x, int y) const {
+    if (x < 0 || x >= row_count || y < 0 || y >= col_count) {
+        return false;
+    }
+    return (words[static_cast<size_t>(x) * stride + (y >> 6)] >> (y & 63)) & 1;
+}
+
+void Bitmap::set(int x, int y, bool value) {
+    if (x < 0 || x >= row_count || y < 0 || y >= col_count) {
+        return;
+    }
+    uint64_t& word = words[static_cast<size_t>(x) * stride + (y >> 6)];
+    uint64_t bit = uint64_t(1) << (y & 63);
+    word = value ? (word | bit) : (word & ~bit);
+}
+
+int Bitmap::popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+template <typename Visit>
+void Bitmap::scan(int x, int y0, int y1, Visit visit) const {
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, col_count - 1);
+    if (x < 0 || x >= row_count || y0 > y1) {
+        return;
+    }
+    const uint64_t* row = words.data() + static_cast<size_t>(x) * stride;
+    int first = y0 >> 6;
+    int last = y1 >> 6;
+    for (int w = first; w <= last; w++) {
+        uint64_t mask = ~uint64_t(0);
+        if (w == first) {
+            mask &= ~uint64_t(0) << (y0 & 63);
+        }
+        if (w == last && (y1 & 63) != 63) {
+            mask &= (uint64_t(1) << ((y1 & 63) + 1)) - 1;
+        }
+        if (!visit(row[w] & mask)) {
+            return;
+        }
+    }
+}
+
+int Bitmap::count(int x0, int y0, int x1, int y1) const {
+    int total = 0;
+    for (int x = std::max(x0, 0); x <= std::min(x1, row_count - 1); x++) {
+        scan(x, y0, y1, [&](uint64_t bits) {
+            total += popcount(bits);
+            return true;
+        });
+    }
+    return total;
+}
+
+bool Bitmap::any(int x, int y0, int y1) const {
+    bool found = false;
+    scan(x, y0, y1, [&](uint64_t bits) {
+        found = bits != 0;
+        return !found;
+    });
+    return found;
+}
+
+bool Bitmap::sight(const Intex& from, const Intex& to) const {
+    if (from.x < 0 || from.x >= row_count || from.y < 0 || from.y >= col_count ||
+        to.x < 0 || to.x >= row_count || to.y < 0 || to.y >= col_count) {
+        return false;
+    }
+    const double eps = 1e-9;
+    double dx = to.x - from.x;
+    double dy = to.y - from.y;
+    int low = std::min(from.x, to.x);
+    int high = std::max(from.x, to.x);
+    for (int x = low; x <= high; x++) {
+        double t0 = 0.0;
+        double t1 = 1.0;
+        if (dx != 0.0) {
+            t0 = (x - 0.5 - from.x) / dx;
+            t1 = (x + 0.5 - from.x) / dx;
+            if (t0 > t1) std::swap(t0, t1);
+            t0 = std::max(t0, 0.0);
+            t1 = std::min(t1, 1.0);
+        }
+        double ya = from.y + t0 * dy;
+        double yb = from.y + t1 * dy;
+        if (ya > yb) std::swap(ya, yb);
+        int y0 = static_cast<int>(std::ceil(ya - 0.5 + eps));
+        int y1 = static_cast<int>(std::floor(yb + 0.5 - eps));
+        if (any(x, y0, y1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int Bitmap::rows() const {
+    return row_count;
+}
+
+int Bitmap::cols() const {
+    return col_count;
+}
+
+bool Bitmap::empty() const {
+    return words.empty();
+}
+
+const std::vector<uint64_t>& Bitmap::data() const {
+    return words;
+}
@@ -364,6 +364,8 @@ SqPlain::SqPlain() {}
 /**
  * @brief 检查点是否在地图边缘且可通行
  * 
+ * 高度为无穷大或负数（Ground::set_unit写入的障碍）的格子不可通行
+ * 
  * @param point 检查的点
  * @return 如果点在地图范围内且可通行返回true，否则返回false
  */
@@ -374,7 +376,7 @@ bool SqPlain::edge_allowed(const SqDot& point) const {
     }
     
 
-    if (map[point.x][point.y] == std::numeric_limits<double>::infinity()) {
+    if (map[point.x][point.y] == std::numeric_limits<double>::infinity() || map[point.x][point.y] < 0.0) {
         return false;
     }
     
@@ -386,7 +388,7 @@ bool SqPlain::edge_allowed(const Intex& point) const {
         return false;
     }
 
-    if (map[point.x][point.y] == std::numeric_limits<double>::infinity()) {
+    if (map[point.x][point.y] == std::numeric_limits<double>::infinity() || map[point.x][point.y] < 0.0) {
         return false;
     }
     
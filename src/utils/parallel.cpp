@@ -0,0 +1,269 @@
+#include "utils/parallel.hpp"
+
+/**
+ * @brief 当前线程所属的线程池及其队列编号，非工作线程为空
+ */
+static thread_local ThreadPool* current_pool = nullptr;
+static thread_local int current_queue = -1;
+
+int hardware_threads() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * @brief 构造函数
+ *
+ * 队列数至少为1，没有工作线程时外部提交的任务进入该队列，由等待者取出执行
+ *
+ * @param threads 工作线程数
+ */
+ThreadPool::ThreadPool(int threads): pending(0), cursor(0), stopping(false) {
+    threads = std::max(threads, 0);
+    int count = std::max(threads, 1);
+    for (int i = 0; i < count; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(threads);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(hardware_threads() - 1);
+    return pool;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    int index = current_pool == this ? current_queue :
+                static_cast<int>(cursor++ % queues.size());
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief 取一个任务：先从自己队列的队尾取，再依次从其他队列的队头窃取
+ *
+ * @param home 自己的队列编号，非工作线程为-1
+ * @param task 取出的任务
+ * @return 所有队列都为空时返回false
+ */
+bool ThreadPool::take(int home, std::function<void()>& task) {
+    int count = static_cast<int>(queues.size());
+    if (home >= 0) {
+        Queue& mine = *queues[home];
+        std::lock_guard<std::mutex> guard(mine.lock);
+        if (!mine.tasks.empty()) {
+            task = std::move(mine.tasks.back());
+            mine.tasks.pop_back();
+            pending--;
+            return true;
+        }
+    }
+    int start = home >= 0 ? home + 1 : 0;
+    for (int k = 0; k < count; k++) {
+        Queue& other = *queues[(start + k) % count];
+        std::lock_guard<std::mutex> guard(other.lock);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::run_one() {
+    std::function<void()> task;
+    if (!take(current_pool == this ? current_queue : -1, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+int ThreadPool::size() const {
+    return static_cast<int>(workers.size());
+}
+
+void ThreadPool::work(int index) {
+    current_pool = this;
+    current_queue = index;
+    while (true) {
+        std::function<void()> task;
+        if (take(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        wake.wait(guard, [&]() {
+            return stopping || pending > 0;
+        });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool): pool(pool), outstanding(0) {}
+
+TaskGroup::~TaskGroup() {
+    drain();
+}
+
+/**
+ * @brief 提交任务
+ *
+ * 计数在锁内减少并通知，等待者只在持锁时看到计数归零后返回，
+ * 因此任务完成后不会再访问已经析构的任务组
+ */
+void TaskGroup::run(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        outstanding++;
+    }
+    pool.submit([this, task = std::move(task)]() {
+        std::exception_ptr error;
+        try {
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        if (error && !failure) {
+            failure = error;
+        }
+        if (--outstanding == 0) {
+            done.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait() {
+    drain();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::swap(error, failure);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief 等待计数归零，不处理异常
+ *
+ * 取不到任务说明剩余任务正在其他线程上执行，此时阻塞到有任务完成；
+ * 超时只用于发现阻塞期间新提交到线程池的任务（如没有工作线程时由任务内部提交的任务）
+ */
+void TaskGroup::drain() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (outstanding > 0) {
+        guard.unlock();
+        bool ran = pool.run_one();
+        guard.lock();
+        if (!ran && outstanding > 0) {
+            done.wait_for(guard, std::chrono::milliseconds(1));
+        }
+    }
+}
+
+/**
+ * @brief 将区间[begin, end)均分为若干段，在共享线程池上执行
+ *
+ * @param begin 区间起点
+ * @param end 区间终点（不含）
+ * @param body 处理子区间[lo, hi)的函数
+ * @param threads 分段数，不大于0时使用hardware_threads()
+ */
+void parallel_for(int begin, int end, const std::function<void(int, int)>& body, int threads) {
+    if (end <= begin) {
+        return;
+    }
+    if (threads <= 0) {
+        threads = hardware_threads();
+    }
+    threads = std::min(threads, end - begin);
+    if (threads == 1) {
+        body(begin, end);
+        return;
+    }
+
+    int step = (end - begin + threads - 1) / threads;
+    TaskGroup group;
+    for (int lo = begin + step; lo < end; lo += step) {
+        int hi = std::min(lo + step, end);
+        group.run([&body, lo, hi]() {
+            body(lo, hi);
+        });
+    }
+    body(begin, std::min(begin + step, end));
+    group.wait();
+}
+
+void parallel_tiles(int rows, int cols, int tile, const std::function<void(int, int, int, int)>& body) {
+    if (rows <= 0 || cols <= 0) {
+        return;
+    }
+    tile = std::max(tile, 1);
+    TaskGroup group;
+    for (int x0 = 0; x0 < rows; x0 += tile) {
+        for (int y0 = 0; y0 < cols; y0 += tile) {
+            int x1 = std::min(x0 + tile, rows);
+            int y1 = std::min(y0 + tile, cols);
+            group.run([&body, x0, x1, y0, y1]() {
+                body(x0, x1, y0, y1);
+            });
+        }
+    }
+    group.wait();
+}
+
+void parallel_team(int threads, const std::function<void(int)>& body) {
+    threads = std::max(threads, 1);
+    std::vector<std::thread> members;
+    members.reserve(threads - 1);
+    for (int rank = 1; rank < threads; rank++) {
+        members.emplace_back(body, rank);
+    }
+    body(0);
+    for (auto& member : members) {
+        member.join();
+    }
+}
+
+Barrier::Barrier(int count): count(count), waiting(0), generation(0) {}
+
+void Barrier::wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    unsigned long arrived = generation;
+    if (++waiting == count) {
+        waiting = 0;
+        generation++;
+        ready.notify_all();
+        return;
+    }
+    ready.wait(guard, [&]() {
+        return generation != arrived;
+    });
+}
@@ -1,10 +1,57 @@
 #include "utils/test_framework.hpp"
 #include "aStar/aStar.hpp"
+#include "aStar/quadtree.hpp"
+#include "aStar/landmark.hpp"
+#include "aStar/hierarchy.hpp"
+#include "aStar/field.hpp"
+#include "aStar/delta.hpp"
+#include "aStar/corridor.hpp"
+#include "aStar/matrix.hpp"
+#include "aStar/planner.hpp"
 #include "ground/ground.hpp"
 #include <iostream>
 #include <limits>
 #include <vector>
 #include <string>
+#include <random>
+#include <fstream>
+#include <iterator>
+
+// 辅助函数：检查路径是否连续、在地图内且不经过障碍物
+static bool valid_path(const SqPlain& graph, const std::vector<Intex>& path) {
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (!graph.edge_allowed(path[i])) {
+            return false;
+        }
+        if (i > 0 && manhattan_distance(path[i - 1], path[i]) != 1.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 辅助函数：计算路径的总代价
+static double path_cost(const SqPlain& graph, const std::vector<Intex>& path) {
+    double total = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        total += graph.cost(path[i - 1], path[i]);
+    }
+    return total;
+}
+
+// 辅助函数：生成带随机高度与障碍物的测试地图
+static SqPlain random_graph(int rows, int cols, unsigned seed) {
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> height(28, 31);
+    std::uniform_int_distribution<int> block(0, 9);
+    SqPlain graph(rows, cols, 0.0);
+    for (int x = 0; x < rows; ++x) {
+        for (int y = 0; y < cols; ++y) {
+            graph[x][y] = block(engine) == 0 ? std::numeric_limits<double>::infinity() : height(engine);
+        }
+    }
+    return graph;
+}
 
 TEST(a_star_search_test) {
     // 创建一个简单的测试地图
@@ -180,6 +227,611 @@ TEST(edge_cases_test) {
     framework.info("edge_cases_test: 通过所有测试用例");
 }
 
+TEST(quad_star_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "四叉树搜索测试";
+
+    framework.info("quad_star_test: 开始测试四叉树搜索");
+
+    // 与A*测试相同的小地图
+    SqPlain small(5, 5, 0.0);
+    small[1][1] = std::numeric_limits<double>::infinity();
+    small[1][2] = std::numeric_limits<double>::infinity();
+    small[1][3] = std::numeric_limits<double>::infinity();
+    small[3][1] = std::numeric_limits<double>::infinity();
+    small[3][2] = std::numeric_limits<double>::infinity();
+
+    QuadTree small_tree(small);
+    auto path = quad_star(small, small_tree, Intex(0, 0), Intex(4, 4));
+    if (path.empty() || path.front() != Intex(0, 0) || path.back() != Intex(4, 4)) {
+        framework.addFailure(testName, {3, 0, 1, static_cast<double>(path.size())});
+    } else if (!valid_path(small, path)) {
+        framework.addFailure(testName, {3, 1, 1, 0});
+    }
+
+    // 大块平地中间一堵带缺口的墙
+    SqPlain open(64, 64, 29.0);
+    for (int x = 0; x < 64; ++x) {
+        if (x < 40 || x > 42) {
+            open[x][31] = std::numeric_limits<double>::infinity();
+        }
+    }
+    QuadTree open_tree(open);
+    if (open_tree.leaves.size() * 10 > 64 * 64) {
+        framework.addFailure(testName, {3, 2, 64 * 64 / 10, static_cast<double>(open_tree.leaves.size())});
+    }
+
+    Intex start(2, 2);
+    Intex goal(60, 60);
+    auto open_path = quad_star(open, open_tree, start, goal);
+    if (open_path.empty() || open_path.front() != start || open_path.back() != goal) {
+        framework.addFailure(testName, {3, 3, 1, static_cast<double>(open_path.size())});
+    } else if (!valid_path(open, open_path)) {
+        framework.addFailure(testName, {3, 4, 1, 0});
+    }
+
+    // 被障碍物包围的终点不可达
+    open[10][10] = std::numeric_limits<double>::infinity();
+    QuadTree closed_tree(open);
+    auto blocked = quad_star(open, closed_tree, start, Intex(10, 10));
+    if (!blocked.empty()) {
+        framework.addFailure(testName, {3, 5, 0, static_cast<double>(blocked.size())});
+    }
+
+    // 四叉树与地图尺寸不符时不搜索
+    auto mismatched = quad_star(SqPlain(32, 32, 0.0), open_tree, start, Intex(20, 20));
+    if (!mismatched.empty()) {
+        framework.addFailure(testName, {3, 6, 0, static_cast<double>(mismatched.size())});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "quad_star_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("quad_star_test: 通过所有测试用例");
+}
+
+TEST(alt_star_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "地标启发式搜索测试";
+
+    framework.info("alt_star_test: 开始测试ALT地标启发式");
+
+    SqPlain graph = random_graph(40, 40, 7);
+    Landmarks marks(graph, 4);
+    if (marks.anchors.size() != 4) {
+        framework.addFailure(testName, {4, 0, 4, static_cast<double>(marks.anchors.size())});
+    }
+
+    std::mt19937 engine(11);
+    std::uniform_int_distribution<int> coord(0, 39);
+    for (int trial = 0; trial < 20; ++trial) {
+        Intex start(coord(engine), coord(engine));
+        Intex goal(coord(engine), coord(engine));
+        if (!graph.edge_allowed(start) || !graph.edge_allowed(goal)) {
+            continue;
+        }
+        double expected = dijkstra(graph, start)[goal.x * graph.cols() + goal.y];
+        auto path = alt_star(graph, marks, start, goal);
+
+        if (expected == std::numeric_limits<double>::infinity()) {
+            if (!path.empty()) {
+                framework.addFailure(testName, {4, 1, 0, static_cast<double>(path.size())});
+            }
+            continue;
+        }
+        // 启发式必须是可采纳的
+        double bound = marks.heuristic(graph, start, goal);
+        if (bound > expected + 1e-9) {
+            framework.addFailure(testName, {4, 2, expected, bound});
+        }
+        // 路径必须连续且代价最优
+        if (path.empty() || path.front() != start || path.back() != goal || !valid_path(graph, path)) {
+            framework.addFailure(testName, {4, 3, 1, 0});
+        } else if (std::abs(path_cost(graph, path) - expected) > 1e-9) {
+            framework.addFailure(testName, {4, 4, expected, path_cost(graph, path)});
+        }
+    }
+
+    // 地标与地图尺寸不符时不搜索
+    if (!alt_star(SqPlain(20, 20, 0.0), marks, Intex(0, 0), Intex(19, 19)).empty()) {
+        framework.addFailure(testName, {4, 5, 0, 1});
+    }
+
+    // 地图修改后旧地标不再使用，路径仍然最优
+    Ground ground(40, 40);
+    for (int x = 0; x < 40; ++x) {
+        for (int y = 0; y < 40; ++y) {
+            ground.map[x][y] = graph[x][y];
+        }
+    }
+    ground.touch();
+    Landmarks built(ground, 4);
+    if (!built.fresh(ground) || marks.fresh(ground)) {
+        framework.addFailure(testName, {4, 6, 1, 0});
+    }
+    for (int y = 0; y < 39; ++y) {
+        ground.set_unit(20, y, true);
+    }
+    if (built.fresh(ground)) {
+        framework.addFailure(testName, {4, 7, 0, 1});
+    }
+    for (int trial = 0; trial < 20; ++trial) {
+        Intex start(coord(engine) / 2, coord(engine));
+        Intex goal(21 + coord(engine) / 3, coord(engine));
+        if (!ground.edge_allowed(start) || !ground.edge_allowed(goal)) {
+            continue;
+        }
+        double expected = dijkstra(ground.map, start)[goal.x * 40 + goal.y];
+        auto path = alt_star(ground, built, start, goal);
+        if (expected == std::numeric_limits<double>::infinity() ? !path.empty() :
+            path.empty() || std::abs(path_cost(ground.map, path) - expected) > 1e-9) {
+            framework.addFailure(testName, {4, 8, expected, path.empty() ? 0.0 : path_cost(ground.map, path)});
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "alt_star_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("alt_star_test: 通过所有测试用例");
+}
+
+TEST(hierarchy_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "收缩层次测试";
+
+    framework.info("hierarchy_test: 开始测试收缩层次");
+
+    SqPlain graph = random_graph(40, 40, 13);
+    std::string filename = IOManager::get_instance().build_path("log/hierarchy_test.bin");
+    Hierarchy built(graph);
+    if (!built.save(filename)) {
+        framework.addFailure(testName, {5, 0, 1, 0});
+    }
+    Hierarchy index;
+    if (!index.load(filename) || index.rows() != 40 || index.cols() != 40) {
+        framework.addFailure(testName, {5, 1, 1, 0});
+    }
+
+    // 损坏的文件不能被读入：边指向越界格子、文件被截断
+    {
+        std::ifstream in(filename, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t cells = 40 * 40;
+        size_t first_arc = 8 + 2 * 4 + (8 + cells * 4) + (8 + cells * 8) + (8 + (cells + 1) * 4) + 8;
+        std::string broken = bytes;
+        int32_t outside = 1 << 20;
+        broken.replace(first_arc, sizeof(outside), reinterpret_cast<const char*>(&outside), sizeof(outside));
+        std::string corrupt = IOManager::get_instance().build_path("log/hierarchy_corrupt.bin");
+        std::ofstream(corrupt, std::ios::binary).write(broken.data(), static_cast<std::streamsize>(broken.size()));
+        Hierarchy rejected(random_graph(5, 5, 3));
+        if (bytes.size() <= first_arc || rejected.load(corrupt) || rejected.rows() != 5) {
+            framework.addFailure(testName, {5, 6, 0, 1});
+        }
+        broken = bytes.substr(0, bytes.size() - 4);
+        std::ofstream(corrupt, std::ios::binary).write(broken.data(), static_cast<std::streamsize>(broken.size()));
+        if (rejected.load(corrupt) || rejected.rows() != 5) {
+            framework.addFailure(testName, {5, 7, 0, 1});
+        }
+    }
+
+    std::mt19937 engine(17);
+    std::uniform_int_distribution<int> coord(0, 39);
+    for (int trial = 0; trial < 30; ++trial) {
+        Intex start(coord(engine), coord(engine));
+        Intex goal(coord(engine), coord(engine));
+        if (!graph.edge_allowed(start) || !graph.edge_allowed(goal)) {
+            continue;
+        }
+        double expected = dijkstra(graph, start)[goal.x * graph.cols() + goal.y];
+        auto path = index.query(start, goal);
+
+        if (expected == std::numeric_limits<double>::infinity()) {
+            if (!path.empty()) {
+                framework.addFailure(testName, {5, 2, 0, static_cast<double>(path.size())});
+            }
+            continue;
+        }
+        // 查询代价与展开后的路径代价都必须最优
+        if (std::abs(index.distance(start, goal) - expected) > 1e-9) {
+            framework.addFailure(testName, {5, 3, expected, index.distance(start, goal)});
+        }
+        if (path.empty() || path.front() != start || path.back() != goal || !valid_path(graph, path)) {
+            framework.addFailure(testName, {5, 4, 1, 0});
+        } else if (std::abs(path_cost(graph, path) - expected) > 1e-9) {
+            framework.addFailure(testName, {5, 5, expected, path_cost(graph, path)});
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "hierarchy_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("hierarchy_test: 通过所有测试用例");
+}
+
+TEST(field_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "代价场测试";
+
+    framework.info("field_test: 开始测试代价场与缓存");
+
+    SqPlain graph = random_graph(30, 30, 19);
+    Intex goal(15, 15);
+    graph.map[goal.x][goal.y] = 30.0;
+    graph.map[0][0] = 30.0;
+    graph.map[29][29] = 30.0;
+    CostField field(graph, goal);
+
+    std::mt19937 engine(23);
+    std::uniform_int_distribution<int> coord(0, 29);
+    for (int trial = 0; trial < 20; ++trial) {
+        Intex start(coord(engine), coord(engine));
+        if (!graph.edge_allowed(start)) {
+            continue;
+        }
+        double expected = dijkstra(graph, start)[goal.x * graph.cols() + goal.y];
+        if (std::abs(field.cost(start) - expected) > 1e-9 &&
+            !(expected == std::numeric_limits<double>::infinity() && field.cost(start) == expected)) {
+            framework.addFailure(testName, {6, 0, expected, field.cost(start)});
+        }
+        auto path = field.descend(graph, start);
+        if (expected == std::numeric_limits<double>::infinity()) {
+            if (!path.empty()) {
+                framework.addFailure(testName, {6, 1, 0, static_cast<double>(path.size())});
+            }
+            continue;
+        }
+        if (path.empty() || path.front() != start || path.back() != goal || !valid_path(graph, path)) {
+            framework.addFailure(testName, {6, 2, 1, 0});
+        } else if (std::abs(path_cost(graph, path) - expected) > 1e-9) {
+            framework.addFailure(testName, {6, 3, expected, path_cost(graph, path)});
+        }
+    }
+
+    // 预算只够容纳两个代价场，第三个写入时淘汰最久未使用的
+    FieldCache cache(2 * field.bytes() + field.bytes() / 2);
+    auto first = cache.get(graph, goal, 0);
+    cache.get(graph, Intex(0, 0), 0);
+    if (cache.get(graph, goal, 0) != first) {
+        framework.addFailure(testName, {6, 4, 1, 0});
+    }
+    cache.get(graph, Intex(29, 29), 0);
+    if (cache.size() != 2 || cache.get(graph, goal, 0) != first) {
+        framework.addFailure(testName, {6, 5, 2, static_cast<double>(cache.size())});
+    }
+    if (cache.get(graph, goal, 1) == first) {
+        framework.addFailure(testName, {6, 6, 1, 0});
+    }
+
+    // 修改地面后版本号递增，缓存不再命中旧的代价场
+    Ground ground(10, 10);
+    uint64_t before = ground.version();
+    ground.set_unit(5, 5, true);
+    if (ground.version() != before + 1) {
+        framework.addFailure(testName, {6, 7, static_cast<double>(before + 1), static_cast<double>(ground.version())});
+    }
+    auto route = cache.path(ground, Intex(0, 0), Intex(9, 9));
+    if (route.empty() || route.front() != Intex(0, 0) || route.back() != Intex(9, 9) || route.size() != 19) {
+        framework.addFailure(testName, {6, 8, 19, static_cast<double>(route.size())});
+    }
+
+    // 两张版本号相同的地图共用一个缓存，各自得到自己的代价场
+    SqPlain other = random_graph(30, 30, 37);
+    other[goal.x][goal.y] = graph[goal.x][goal.y];
+    auto mine = cache.get(graph, goal, 0);
+    auto theirs = cache.get(other, goal, 0);
+    if (mine == theirs || theirs->cost(Intex(0, 0)) != CostField(other, goal).cost(Intex(0, 0))) {
+        framework.addFailure(testName, {6, 9, 1, 0});
+    }
+    Ground left(10, 10);
+    Ground right(10, 10);
+    for (int x = 0; x < 9; ++x) {
+        right.set_unit(x, 5, true);
+    }
+    while (left.version() < right.version()) {
+        left.set_unit(0, 0, false);
+    }
+    auto open_route = cache.path(left, Intex(0, 0), Intex(0, 9));
+    auto wall_route = cache.path(right, Intex(0, 0), Intex(0, 9));
+    if (left.version() != right.version() || open_route.size() != 10 || wall_route.size() <= 10) {
+        framework.addFailure(testName, {6, 10, 10, static_cast<double>(wall_route.size())});
+    }
+    Ground copy = right;
+    if (copy.id() == right.id()) {
+        framework.addFailure(testName, {6, 11, 1, 0});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "field_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("field_test: 通过所有测试用例");
+}
+
+TEST(delta_stepping_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "并行最短路径测试";
+
+    framework.info("delta_stepping_test: 开始测试delta-stepping");
+
+    SqPlain graph = random_graph(70, 50, 29);
+    // set_unit写入的障碍高度为-1，默认桶宽只能取自可通行格子
+    graph[35][25] = -1.0;
+    std::mt19937 engine(31);
+    std::uniform_int_distribution<int> row(0, 69);
+    std::uniform_int_distribution<int> col(0, 49);
+    for (int trial = 0; trial < 4; ++trial) {
+        Intex source(row(engine), col(engine));
+        auto expected = dijkstra(graph, source);
+        // 覆盖默认桶宽、需要多轮的宽桶以及不同线程数
+        for (double delta : {0.0, 100.0}) {
+            for (int threads : {1, 3}) {
+                auto actual = delta_stepping(graph, source, delta, threads);
+                if (actual.size() != expected.size()) {
+                    framework.addFailure(testName, {7, 0, static_cast<double>(expected.size()), static_cast<double>(actual.size())});
+                    continue;
+                }
+                for (size_t id = 0; id < expected.size(); id++) {
+                    if (actual[id] != expected[id]) {
+                        framework.addFailure(testName, {7, 1, expected[id], actual[id]});
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "delta_stepping_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("delta_stepping_test: 通过所有测试用例");
+}
+
+TEST(corridor_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "走廊细化测试";
+
+    framework.info("corridor_test: 开始测试走廊内细化搜索");
+
+    // 局部下标与格子坐标互为逆映射，走廊只覆盖折线附近的格子
+    SqPlain open(40, 40, 0.0);
+    Corridor corridor(open, {Intex(2, 2), Intex(2, 30), Intex(30, 30)}, 2);
+    int counted = 0;
+    for (int x = 0; x < 40; ++x) {
+        for (int y = 0; y < 40; ++y) {
+            int local = corridor.index(Intex(x, y));
+            bool near = (x <= 4 && y <= 32) || (x <= 32 && y >= 28 && y <= 32);
+            if ((local >= 0) != near || (local >= 0 && corridor.cell(local) != Intex(x, y))) {
+                framework.addFailure(testName, {8, 0, static_cast<double>(near), static_cast<double>(local)});
+            }
+            counted += local >= 0 ? 1 : 0;
+        }
+    }
+    if (counted != corridor.size()) {
+        framework.addFailure(testName, {8, 1, static_cast<double>(counted), static_cast<double>(corridor.size())});
+    }
+
+    SqPlain graph = random_graph(60, 60, 37);
+    std::mt19937 engine(41);
+    std::uniform_int_distribution<int> coord(0, 59);
+    for (int trial = 0; trial < 15; ++trial) {
+        Intex start(coord(engine), coord(engine));
+        Intex goal(coord(engine), coord(engine));
+        if (!graph.edge_allowed(start) || !graph.edge_allowed(goal)) {
+            continue;
+        }
+        double expected = dijkstra(graph, start)[goal.x * graph.cols() + goal.y];
+        auto path = refine_star(graph, start, goal, 0.25, 3);
+        if (expected == std::numeric_limits<double>::infinity()) {
+            if (!path.empty()) {
+                framework.addFailure(testName, {8, 2, 0, static_cast<double>(path.size())});
+            }
+            continue;
+        }
+        if (path.empty() || path.front() != start || path.back() != goal || !valid_path(graph, path)) {
+            framework.addFailure(testName, {8, 3, 1, 0});
+            continue;
+        }
+        if (path_cost(graph, path) < expected - 1e-9) {
+            framework.addFailure(testName, {8, 4, expected, path_cost(graph, path)});
+        }
+        // 分段并行细化的结果与线程数无关
+        auto pieces = segment_star(graph, start, goal, 0.25, 3, 1);
+        if (pieces.empty() || pieces.front() != start || pieces.back() != goal || !valid_path(graph, pieces)) {
+            framework.addFailure(testName, {8, 6, 1, 0});
+        } else if (segment_star(graph, start, goal, 0.25, 3, 3) != pieces) {
+            framework.addFailure(testName, {8, 7, 1, 0});
+        }
+        // 走廊覆盖全图时与最优代价一致
+        auto full = corridor_star(graph, start, goal, Corridor(graph, {start, goal}, 60));
+        if (full.empty() || std::abs(path_cost(graph, full) - expected) > 1e-9) {
+            framework.addFailure(testName, {8, 5, expected, full.empty() ? 0.0 : path_cost(graph, full)});
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "corridor_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("corridor_test: 通过所有测试用例");
+}
+
+TEST(matrix_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "代价矩阵测试";
+
+    framework.info("matrix_test: 开始测试代价矩阵与访问顺序");
+
+    SqPlain graph = random_graph(40, 40, 43);
+    std::mt19937 engine(47);
+    std::uniform_int_distribution<int> coord(0, 39);
+    std::vector<Intex> points;
+    while (points.size() < 8) {
+        Intex point(coord(engine), coord(engine));
+        if (graph.edge_allowed(point)) {
+            points.push_back(point);
+        }
+    }
+    points.push_back(points[2]);
+
+    for (int threads : {1, 3}) {
+        auto matrix = cost_matrix(graph, points, threads);
+        for (size_t i = 0; i < points.size(); ++i) {
+            auto expected = dijkstra(graph, points[i]);
+            for (size_t j = 0; j < points.size(); ++j) {
+                double want = expected[points[j].x * graph.cols() + points[j].y];
+                if (matrix[i][j] != want) {
+                    framework.addFailure(testName, {9, static_cast<double>(threads), want, matrix[i][j]});
+                }
+            }
+        }
+    }
+
+    // 不同连通分量之间为无穷大
+    Ground ground(10, 10);
+    for (int y = 0; y < 10; ++y) {
+        ground.set_unit(5, y, true);
+    }
+    auto split = cost_matrix(ground, {Intex(0, 0), Intex(9, 9), Intex(0, 9)});
+    if (split[0][1] != std::numeric_limits<double>::infinity() || split[0][2] != 9.0) {
+        framework.addFailure(testName, {9, 4, 9.0, split[0][2]});
+    }
+
+    // 直线上的点，最优访问顺序为依次前进
+    std::vector<Intex> line;
+    for (int y : {0, 12, 3, 9, 6, 15}) {
+        line.push_back(Intex(0, y));
+    }
+    auto order = visit_order(cost_matrix(SqPlain(1, 16, 0.0), line));
+    std::vector<int> expected_order{0, 2, 4, 3, 1, 5};
+    if (order != expected_order) {
+        framework.addFailure(testName, {9, 5, 15.0, tour_cost(cost_matrix(SqPlain(1, 16, 0.0), line), order)});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "matrix_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("matrix_test: 通过所有测试用例");
+}
+
+TEST(nearest_star_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "最近终点搜索测试";
+
+    framework.info("nearest_star_test: 开始测试多终点搜索");
+
+    SqPlain graph = random_graph(40, 40, 53);
+    std::mt19937 engine(59);
+    std::uniform_int_distribution<int> coord(0, 39);
+    for (int trial = 0; trial < 10; ++trial) {
+        Intex start(coord(engine), coord(engine));
+        if (!graph.edge_allowed(start)) {
+            continue;
+        }
+        // 少量终点使用精确启发式，大量终点使用包围盒启发式
+        for (int count : {4, 40}) {
+            std::vector<Intex> goals;
+            for (int k = 0; k < count; ++k) {
+                goals.push_back(Intex(coord(engine), coord(engine)));
+            }
+            auto distance = dijkstra(graph, start);
+            double expected = std::numeric_limits<double>::infinity();
+            for (const auto& goal : goals) {
+                expected = std::min(expected, distance[goal.x * graph.cols() + goal.y]);
+            }
+            auto path = nearest_star(graph, start, goals);
+            if (expected == std::numeric_limits<double>::infinity()) {
+                if (!path.empty()) {
+                    framework.addFailure(testName, {10, 0, 0, static_cast<double>(path.size())});
+                }
+                continue;
+            }
+            if (path.empty() || path.front() != start || !valid_path(graph, path) ||
+                std::find(goals.begin(), goals.end(), path.back()) == goals.end()) {
+                framework.addFailure(testName, {10, 1, 1, 0});
+            } else if (std::abs(path_cost(graph, path) - expected) > 1e-9) {
+                framework.addFailure(testName, {10, 2, expected, path_cost(graph, path)});
+            }
+        }
+    }
+
+    // 地面上与起点不连通的终点被剔除
+    Ground ground(10, 10);
+    for (int y = 0; y < 10; ++y) {
+        ground.set_unit(5, y, true);
+    }
+    auto path = nearest_star(ground, Intex(0, 0), {Intex(6, 0), Intex(0, 8)});
+    if (path.empty() || path.back() != Intex(0, 8)) {
+        framework.addFailure(testName, {10, 3, 1, 0});
+    }
+    if (!nearest_star(ground, Intex(0, 0), {Intex(6, 0), Intex(9, 9)}).empty()) {
+        framework.addFailure(testName, {10, 4, 0, 1});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "nearest_star_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("nearest_star_test: 通过所有测试用例");
+}
+
+TEST(planner_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "批量规划测试";
+
+    framework.info("planner_test: 开始测试批量规划");
+
+    Ground ground(50, 50);
+    ground.map = random_graph(50, 50, 61);
+    ground.touch();
+    const SqPlain& graph = ground.map;
+
+    std::mt19937 engine(67);
+    std::uniform_int_distribution<int> coord(0, 49);
+    std::vector<Query> queries;
+    for (int k = 0; k < 40; ++k) {
+        queries.push_back({Intex(coord(engine), coord(engine)), Intex(coord(engine), coord(engine))});
+    }
+
+    Planner single(ground, 1);
+    Planner pooled(ground, 3);
+    auto first = single.plan(queries);
+    auto second = pooled.plan(queries);
+    if (first != second) {
+        framework.addFailure(testName, {11, 0, 1, 0});
+    }
+    for (size_t k = 0; k < queries.size(); ++k) {
+        const auto& query = queries[k];
+        double expected = graph.edge_allowed(query.start) ?
+            dijkstra(graph, query.start)[query.goal.x * graph.cols() + query.goal.y] : std::numeric_limits<double>::infinity();
+        const auto& path = first[k];
+        if (expected == std::numeric_limits<double>::infinity()) {
+            if (!path.empty()) {
+                framework.addFailure(testName, {11, 1, 0, static_cast<double>(path.size())});
+            }
+            continue;
+        }
+        if (path.empty() || path.front() != query.start || path.back() != query.goal || !valid_path(graph, path)) {
+            framework.addFailure(testName, {11, 2, 1, 0});
+        } else if (std::abs(path_cost(graph, path) - expected) > 1e-9) {
+            framework.addFailure(testName, {11, 3, expected, path_cost(graph, path)});
+        }
+        if (pooled.plan(query.start, query.goal) != path) {
+            framework.addFailure(testName, {11, 4, 1, 0});
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "error_type", "expected", "actual"};
+    framework.writeFailures(testName, "planner_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("planner_test: 通过所有测试用例");
+}
+
 int main(int argc, char* argv[]) {
     try {
         // 设置工作目录
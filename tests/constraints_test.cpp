@@ -1,8 +1,13 @@
 #include "utils/test_framework.hpp"
 #include "robot/robot.hpp"
+#include "robot/footprint.hpp"
+#include "robot/stencil.hpp"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <tuple>
+#include <random>
+#include <cmath>
 
 TEST(spacing_constraint_test) {
     // 测试足部间距约束检查
@@ -55,6 +60,425 @@ TEST(spacing_constraint_test) {
     framework.info("spacing_constraint_test: 通过所有测试用例");
 }
 
+TEST(footprint_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "足部光栅化测试";
+
+    framework.info("footprint_test: 开始测试足部光栅化");
+
+    // 未旋转且边界落在格线上时恰好覆盖 5 × 3 个完整格子
+    Foot foot(SqDot(10, 20), 0.0, 5.0, 3.0);
+    auto cells = foot.cover();
+    if (cells.size() != 15) {
+        framework.addFailure(testName, {1, 0, 15, static_cast<double>(cells.size())});
+    }
+    for (const auto& cell : cells) {
+        if (std::abs(cell.x - 10) > 2 || std::abs(cell.y - 20) > 1) {
+            framework.addFailure(testName, {1, 1, 0, cell.x * 100 + cell.y});
+            break;
+        }
+    }
+
+    // 任意位姿下每个格子的覆盖面积为正，且总和等于矩形面积，说明没有漏掉或多出格子
+    std::mt19937 engine(71);
+    std::uniform_real_distribution<double> offset(-3.0, 3.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    for (int trial = 0; trial < 200; ++trial) {
+        double cx = 30.0 + offset(engine);
+        double cy = 30.0 + offset(engine);
+        double rz = angle(engine);
+        FootSpan spans[footprint_rows];
+        double weights[1024];
+        int rows = rasterize_foot(cx, cy, rz, 5.0, 3.0, spans, footprint_rows);
+        int count = foot_weights(cx, cy, rz, 5.0, 3.0, spans, rows, weights, 1024);
+        if (rows <= 0 || count <= 0) {
+            framework.addFailure(testName, {2, static_cast<double>(trial), 1, 0});
+            continue;
+        }
+        double total = 0.0;
+        for (int k = 0; k < count; ++k) {
+            if (weights[k] <= 1e-12) {
+                framework.addFailure(testName, {3, static_cast<double>(trial), 0, weights[k]});
+            }
+            total += weights[k];
+        }
+        if (std::abs(total - 15.0) > 1e-6) {
+            framework.addFailure(testName, {4, static_cast<double>(trial), 15.0, total});
+        }
+    }
+
+    // 缓冲区不足时返回-1
+    FootSpan small[2];
+    if (rasterize_foot(0.0, 0.0, 0.3, 5.0, 3.0, small, 2) != -1) {
+        framework.addFailure(testName, {5, 0, -1, 0});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "footprint_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("footprint_test: 通过所有测试用例");
+}
+
+TEST(stencil_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "足部模板测试";
+
+    framework.info("stencil_test: 开始测试足部模板缓存");
+
+    auto order = [](std::vector<SqDot> points) {
+        std::sort(points.begin(), points.end(), [](const SqDot& a, const SqDot& b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+        return points;
+    };
+
+    // 整数格子、量化朝向上的模板平移结果与直接计算一致
+    StencilCache cache(16);
+    for (int h = 0; h < 16; ++h) {
+        double rz = h * 2.0 * M_PI / 16;
+        const Stencil& stencil = cache.get(5.0, 3.0, rz + 0.05);
+        Foot foot(SqDot(17, 23), rz, 5.0, 3.0);
+        if (order(stencil.cover(Intex(17, 23))) != order(foot.cover())) {
+            framework.addFailure(testName, {1, static_cast<double>(h), 1, 0});
+        }
+        auto expected = foot.corner();
+        auto actual = stencil.corner(SqDot(17, 23));
+        for (size_t k = 0; k < expected.size(); ++k) {
+            if (std::abs(expected[k].x - actual[k].x) > 1e-9 || std::abs(expected[k].y - actual[k].y) > 1e-9) {
+                framework.addFailure(testName, {2, static_cast<double>(h), expected[k].x, actual[k].x});
+                break;
+            }
+        }
+    }
+
+    // 同一键只创建一次，地址保持不变
+    const Stencil* first = &cache.get(5.0, 3.0, 0.0);
+    cache.get(4.0, 3.0, 0.0);
+    if (&cache.get(5.0, 3.0, 2.0 * M_PI) != first || cache.size() != 17) {
+        framework.addFailure(testName, {3, 0, 17, static_cast<double>(cache.size())});
+    }
+
+    // 整数格子、量化朝向上的Foot::spans取自共享模板，与直接光栅化一致
+    StencilCache& shared = StencilCache::shared();
+    for (int h = 0; h < 64; h += 5) {
+        double rz = h * 2.0 * M_PI / 64;
+        Foot foot(SqDot(17, 23), rz, 4.5, 2.5);
+        FootSpan routed[footprint_rows];
+        FootSpan direct[footprint_rows];
+        int count = foot.spans(routed, footprint_rows);
+        int expected = rasterize_foot(17.0, 23.0, rz, 4.5, 2.5, direct, footprint_rows);
+        bool same = count == expected;
+        for (int k = 0; same && k < count; ++k) {
+            same = routed[k].x == direct[k].x && routed[k].y0 == direct[k].y0 && routed[k].y1 == direct[k].y1;
+        }
+        if (!same || !shared.aligned(rz) || shared.aligned(rz + 0.01)) {
+            framework.addFailure(testName, {4, static_cast<double>(h), static_cast<double>(expected), static_cast<double>(count)});
+        }
+    }
+    if (&StencilCache::shared(32) == &shared || &StencilCache::shared(64) != &shared) {
+        framework.addFailure(testName, {5, 0, 1, 0});
+    }
+
+    // 超过footprint_rows行的足部平移时返回-1，落足检查据此拒绝
+    const Stencil& huge = cache.get(footprint_rows + 10.0, 3.0, 0.0);
+    FootSpan rows[footprint_rows];
+    Foot wide(SqDot(17, 23), 0.0, footprint_rows + 10.0, 3.0);
+    if (!huge.oversized || huge.place(Intex(17, 23), rows, footprint_rows) != -1 ||
+        wide.spans(rows, footprint_rows) != -1) {
+        framework.addFailure(testName, {6, 0, -1, static_cast<double>(huge.place(Intex(17, 23), rows, footprint_rows))});
+    }
+    // 超过footprint_rows行时Foot::cover改用堆缓冲区，仍给出全部覆盖格子
+    size_t cells = wide.cover().size();
+    if (cells != static_cast<size_t>(footprint_rows + 11) * 3) {
+        framework.addFailure(testName, {7, 0, (footprint_rows + 11) * 3.0, static_cast<double>(cells)});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "stencil_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("stencil_test: 通过所有测试用例");
+}
+
+TEST(fit_target_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "目标点调整测试";
+
+    framework.info("fit_target_test: 开始测试目标点调整");
+
+    Ground ground(60, 60);
+    for (int x = 47; x <= 53; ++x) {
+        for (int y = 47; y <= 53; ++y) {
+            ground.set_unit(x, y, true);
+        }
+    }
+    Footholds footholds(ground, 5.0, 3.0, 16);
+
+    Robot robot(40, M_PI * 75/180, 10, 2, 5, 3);
+    robot.feet[0].position = SqDot(30, 50);
+    robot.feet[1].position = SqDot(30, 45);
+    robot.now_which_foot_to_move = WhichFoot::Right;
+
+    // 空地上的目标点保持不变
+    SqDot kept = robot.fit_target(ground, SqDot(40, 50));
+    if (kept.x != 40 || kept.y != 50) {
+        framework.addFailure(testName, {1, kept.x, 40, kept.y});
+    }
+
+    // 障碍上的目标点移到最近的可落足格子，查表与逐格判断结果一致
+    SqDot goal(50, 50);
+    SqDot fitted = robot.fit_target(ground, goal);
+    SqDot looked = robot.fit_target(footholds, goal);
+    if (fitted.x != looked.x || fitted.y != looked.y) {
+        framework.addFailure(testName, {2, fitted.x * 100 + fitted.y, looked.x * 100 + looked.y, 0});
+    }
+    if (!footholds.fits(fitted, 0.0) || goal.distance(fitted) > robot.max_foot_separation || goal.distance(fitted) < 3.0) {
+        framework.addFailure(testName, {3, fitted.x, fitted.y, goal.distance(fitted)});
+    }
+
+    // 随机地形、随机朝向下两个重载的朝向量化相同，选出同一格子
+    std::mt19937 engine(46);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_real_distribution<double> bump(0.0, 0.6);
+    std::uniform_real_distribution<double> coord(8.0, 52.0);
+    Ground rough(60, 60);
+    for (int x = 0; x < 60; ++x) {
+        for (int y = 0; y < 60; ++y) {
+            rough.map[x][y] = percent(engine) < 8 ? -1.0 : 0.05 * x + bump(engine);
+        }
+    }
+    rough.touch();
+    Footholds rough_holds(rough, 5.0, 3.0, 16);
+    for (int trial = 0; trial < 60; ++trial) {
+        robot.feet[0].position = SqDot(coord(engine), coord(engine));
+        SqDot target(std::round(coord(engine)), std::round(coord(engine)));
+        SqDot exact = robot.fit_target(rough, target, rough_holds.headings());
+        SqDot table = robot.fit_target(rough_holds, target);
+        if (exact.x != table.x || exact.y != table.y) {
+            framework.addFailure(testName, {5, static_cast<double>(trial), table.x * 100 + table.y, exact.x * 100 + exact.y});
+        }
+    }
+    robot.feet[0].position = SqDot(30, 50);
+
+    // 范围内没有可落足格子时摆动脚不动
+    Ground blocked(20, 20);
+    for (int x = 0; x < 20; ++x) {
+        for (int y = 0; y < 20; ++y) {
+            blocked.set_unit(x, y, true);
+        }
+    }
+    SqDot stay = robot.fit_target(blocked, SqDot(10, 10));
+    if (stay.x != 30 || stay.y != 45) {
+        framework.addFailure(testName, {4, stay.x, 30, stay.y});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "fit_target_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("fit_target_test: 通过所有测试用例");
+}
+
+TEST(settle_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "落足细化测试";
+
+    framework.info("settle_test: 开始测试落足细化");
+
+    // 碗形地形，越靠近中心越平
+    Ground ground(60, 60);
+    for (int x = 0; x < 60; ++x) {
+        for (int y = 0; y < 60; ++y) {
+            ground.map[x][y] = 0.02 * ((x - 30) * (x - 30) + (y - 30) * (y - 30));
+        }
+    }
+    ground.touch();
+
+    // 与半径内逐格拟合的最小值比较
+    Foot foot(SqDot(33, 33), 0.4, 5.0, 3.0);
+    SettleResult settled = foot.settle(ground, 3);
+    double exhaustive = INFINITY;
+    int disk = 0;
+    for (int dx = -3; dx <= 3; ++dx) {
+        for (int dy = -3; dy <= 3; ++dy) {
+            if (dx * dx + dy * dy > 9) {
+                continue;
+            }
+            disk++;
+            FootSpan spans[footprint_rows];
+            int count = Foot(SqDot(33 + dx, 33 + dy), 0.4, 5.0, 3.0).spans(spans, footprint_rows);
+            exhaustive = std::min(exhaustive, ground.trip(spans, count).normal_angle());
+        }
+    }
+    FootSpan start[footprint_rows];
+    double original = ground.trip(start, foot.spans(start, footprint_rows)).normal_angle();
+    if (settled.result != SlideResult::Modified || std::abs(settled.angle - exhaustive) > 1e-9 || settled.angle >= original) {
+        framework.addFailure(testName, {1, settled.angle, exhaustive, original});
+    }
+    if (settled.fits >= disk) {
+        framework.addFailure(testName, {2, 0, static_cast<double>(disk), static_cast<double>(settled.fits)});
+    }
+
+    // 更平的位置被障碍占据时不会移过去
+    Ground blocked = ground;
+    for (int x = 26; x <= 34; ++x) {
+        for (int y = 26; y <= 32; ++y) {
+            blocked.set_unit(x, y, true);
+        }
+    }
+    SettleResult avoided = foot.settle(blocked, 3);
+    if (avoided.result != SlideResult::NoModification || avoided.position.x != 33 || avoided.position.y != 33) {
+        framework.addFailure(testName, {3, avoided.position.x, 33, avoided.position.y});
+    }
+
+    // 落足区域整体平移后站立角度不增大
+    std::vector<SqDot> area = foot.cover();
+    std::vector<SqDot> before = area;
+    auto tilt = [&ground](const std::vector<SqDot>& points) {
+        double angle = ground.stand_angle(points);
+        return std::min(angle, M_PI - angle);
+    };
+    double before_angle = tilt(area);
+    SlideResult slid = foot.shape.slide(area, ground);
+    double after_angle = tilt(area);
+    if (slid != SlideResult::Modified || after_angle > before_angle || area.size() != before.size()) {
+        framework.addFailure(testName, {4, static_cast<double>(slid == SlideResult::Modified), before_angle, after_angle});
+    } else {
+        for (size_t i = 1; i < area.size(); ++i) {
+            if (area[i].x - before[i].x != area[0].x - before[0].x || area[i].y - before[i].y != area[0].y - before[0].y) {
+                framework.addFailure(testName, {5, static_cast<double>(i), 0, 1});
+                break;
+            }
+        }
+    }
+
+    // 台阶地形上总体不劣于原先沿法向量水平分量逐格平移的结果；平移不再必经，单个位置可能停在别的局部最小处
+    Ground terraced(60, 60);
+    for (int x = 0; x < 60; ++x) {
+        for (int y = 0; y < 60; ++y) {
+            terraced.map[x][y] = 0.7 * (y / 5) + 0.4 * (x / 7) + 0.05 * ((x * 7 + y * 3) % 5);
+        }
+    }
+    terraced.touch();
+    auto terrace_tilt = [&terraced](const std::vector<SqDot>& points) {
+        double angle = terraced.stand_angle(points);
+        return std::isnan(angle) ? static_cast<double>(INFINITY) : std::min(angle, M_PI - angle);
+    };
+    // 原先的做法：原位与正向3个平移都拟合，正向没有更平时再拟合反向3个
+    auto previous = [&terraced, &terrace_tilt](std::vector<SqDot> points, int& fits) {
+        SqDot vector = terraced.normal(points).slide();
+        double best = terrace_tilt(points);
+        fits = 1;
+        std::vector<SqDot> chosen = points;
+        for (int sign : {1, -1}) {
+            for (int i = 1; i <= 3; ++i) {
+                std::vector<SqDot> moved;
+                for (const auto& point : points) {
+                    int x = point.x + sign * vector.x * i;
+                    int y = point.y + sign * vector.y * i;
+                    if (x < 0 || x >= 60 || y < 0 || y >= 60) {
+                        moved.clear();
+                        break;
+                    }
+                    moved.emplace_back(x, y);
+                }
+                if (moved.empty()) {
+                    continue;
+                }
+                fits++;
+                if (terrace_tilt(moved) < best) {
+                    best = terrace_tilt(moved);
+                    chosen = moved;
+                }
+            }
+            if (chosen != points) {
+                break;
+            }
+        }
+        return best;
+    };
+    int old_fits = 0;
+    int new_fits = 0;
+    double old_tilt = 0.0;
+    double new_tilt = 0.0;
+    for (int k = 0; k < 60; ++k) {
+        std::vector<SqDot> points = Foot(SqDot(10 + k % 8 * 5, 10 + k / 8 * 5), k * 0.37, 5.0, 3.0).cover();
+        int walked = 0;
+        int descended = 0;
+        double reference = previous(points, walked);
+        foot.shape.slide(points, terraced, 3, descended);
+        old_fits += walked;
+        new_fits += descended;
+        old_tilt += reference;
+        new_tilt += terrace_tilt(points);
+    }
+    if (new_tilt > old_tilt) {
+        framework.addFailure(testName, {7, 0, old_tilt, new_tilt});
+    }
+    // 下降为主、平移只作后备时，精确拟合次数少于原先的平移
+    if (new_fits >= old_fits) {
+        framework.addFailure(testName, {8, 0, static_cast<double>(old_fits), static_cast<double>(new_fits)});
+    }
+
+    // 平坦地面上不移动
+    Ground flat(30, 30);
+    std::vector<SqDot> still = Foot(SqDot(15, 15), 0.0, 5.0, 3.0).cover();
+    if (foot.shape.slide(still, flat) != SlideResult::NoModification ||
+        Foot(SqDot(15, 15), 0.0, 5.0, 3.0).settle(flat).result != SlideResult::NoModification) {
+        framework.addFailure(testName, {6, 0, 0, 1});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "settle_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("settle_test: 通过所有测试用例");
+}
+
+TEST(swing_constraint_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "摆动越障约束测试";
+
+    framework.info("swing_constraint_test: 开始测试摆动越障约束");
+
+    // 第15列有一道高2的土坎
+    Ground ground(30, 30);
+    for (int x = 0; x < 30; ++x) {
+        ground.map[x][15] = 2.0;
+    }
+    ground.touch();
+    SwingTable table(ground.map);
+
+    Robot robot(40, M_PI * 75/180, 10, 2, 5, 3);
+    robot.feet[0].position = SqDot(12, 10);
+    robot.feet[1].position = SqDot(10, 10);
+    robot.now_which_foot_to_move = WhichFoot::Right;
+
+    std::vector<std::tuple<SqDot, double, bool>> test_cases = {
+        {SqDot(10, 20), 1.0, false},
+        {SqDot(10, 20), 2.0, true},
+        {SqDot(14, 13), 0.5, true},
+        {SqDot(20, 14), 0.0, true},
+        {SqDot(20, 16), 0.0, false},
+        {SqDot(40, 10), 5.0, false}
+    };
+    for (auto& test_case : test_cases) {
+        SqDot pos = std::get<0>(test_case);
+        bool expected = std::get<2>(test_case);
+        bool actual = robot.satisfy_swing(table, pos, std::get<1>(test_case));
+        if (expected != actual) {
+            framework.addFailure(testName, {pos.x, pos.y, static_cast<double>(expected), static_cast<double>(actual)});
+        }
+    }
+
+    std::vector<std::string> columnNames = {"position_x", "position_y", "expected", "actual"};
+    framework.writeFailures(testName, "swing_constraint_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("swing_constraint_test: 通过所有测试用例");
+}
+
 int main (int argc, char* argv[]) {
     try {
         // 设置工作目录
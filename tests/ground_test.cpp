@@ -0,0 +1,1173 @@
+#include "utils/test_framework.hpp"
+#include "ground/ground.hpp"
+#include "ground/component.hpp"
+#include "utils/bitmap.hpp"
+#include "ground/clearance.hpp"
+#include "ground/erosion.hpp"
+#include "ground/plane.hpp"
+#include "ground/slope.hpp"
+#include "ground/foothold.hpp"
+#include "ground/sampler.hpp"
+#include "ground/swing.hpp"
+#include "aStar/aStar.hpp"
+#include <iostream>
+#include <limits>
+#include <vector>
+#include <string>
+#include <random>
+#include <queue>
+#include <tuple>
+#include <fstream>
+#include <cstring>
+#include <iterator>
+
+/**
+ * @brief 按广度优先搜索逐个标记连通分量，作为参考结果
+ */
+static std::vector<int> flood_labels(const SqPlain& graph) {
+    int rows = graph.rows();
+    int cols = graph.cols();
+    std::vector<int> labels(static_cast<size_t>(rows) * cols, -1);
+    int next_label = 0;
+    for (int x = 0; x < rows; ++x) {
+        for (int y = 0; y < cols; ++y) {
+            if (!graph.edge_allowed(Intex(x, y)) || labels[x * cols + y] >= 0) {
+                continue;
+            }
+            std::queue<Intex> frontier;
+            frontier.push(Intex(x, y));
+            labels[x * cols + y] = next_label;
+            while (!frontier.empty()) {
+                Intex current = frontier.front();
+                frontier.pop();
+                for (auto& next : graph.get_valid_neighbours(current)) {
+                    if (labels[next.x * cols + next.y] < 0) {
+                        labels[next.x * cols + next.y] = next_label;
+                        frontier.push(next);
+                    }
+                }
+            }
+            next_label++;
+        }
+    }
+    return labels;
+}
+
+/**
+ * @brief 比较连通分量索引与参考标记是否给出相同的划分
+ */
+static bool same_partition(const SqPlain& graph, const Components& components) {
+    auto labels = flood_labels(graph);
+    int cols = graph.cols();
+    std::vector<int> seen(labels.size(), -1);
+    for (int x = 0; x < graph.rows(); ++x) {
+        for (int y = 0; y < cols; ++y) {
+            int expected = labels[x * cols + y];
+            int actual = components.label(Intex(x, y));
+            if ((expected < 0) != (actual < 0)) {
+                return false;
+            }
+            if (expected < 0) {
+                continue;
+            }
+            if (seen[expected] < 0) {
+                seen[expected] = actual;
+            } else if (seen[expected] != actual) {
+                return false;
+            }
+        }
+    }
+    // 不同的参考分量不能共用同一个代表元
+    std::vector<int> roots;
+    for (int root : seen) {
+        if (root >= 0) roots.push_back(root);
+    }
+    std::sort(roots.begin(), roots.end());
+    return std::adjacent_find(roots.begin(), roots.end()) == roots.end();
+}
+
+TEST(component_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "连通分量测试";
+
+    framework.info("component_test: 开始测试连通分量标记");
+
+    std::mt19937 engine(37);
+    std::uniform_int_distribution<int> percent(0, 99);
+    SqPlain graph(60, 50, 30.0);
+    for (int x = 0; x < 60; ++x) {
+        for (int y = 0; y < 50; ++y) {
+            if (percent(engine) < 40) {
+                graph.map[x][y] = std::numeric_limits<double>::infinity();
+            }
+        }
+    }
+
+    for (int threads : {1, 4}) {
+        Components components(graph, threads);
+        if (!same_partition(graph, components)) {
+            framework.addFailure(testName, {0, static_cast<double>(threads), 1, 0});
+        }
+    }
+
+    // 逐格修改后增量更新的结果应与重新标记一致
+    Components components(graph, 2);
+    std::uniform_int_distribution<int> row(0, 59);
+    std::uniform_int_distribution<int> col(0, 49);
+    for (int edit = 0; edit < 200; ++edit) {
+        Intex cell(row(engine), col(engine));
+        graph.map[cell.x][cell.y] = percent(engine) < 50 ? 30.0 : std::numeric_limits<double>::infinity();
+        components.update(graph, cell);
+        if (edit % 20 == 0 && !same_partition(graph, components)) {
+            framework.addFailure(testName, {1, static_cast<double>(edit), 1, 0});
+        }
+    }
+    if (!same_partition(graph, components)) {
+        framework.addFailure(testName, {1, 200, 1, 0});
+    }
+
+    // 小地图上反复封堵、重新开放，每次修改后都与重新标记一致
+    SqPlain small(4, 6, 1.0);
+    Components incremental(small, 1);
+    std::uniform_int_distribution<int> small_row(0, 3);
+    std::uniform_int_distribution<int> small_col(0, 5);
+    for (int edit = 0; edit < 2000; ++edit) {
+        Intex cell(small_row(engine), small_col(engine));
+        small.map[cell.x][cell.y] = percent(engine) < 55 ? 1.0 : std::numeric_limits<double>::infinity();
+        incremental.update(small, cell);
+        if (!same_partition(small, incremental)) {
+            framework.addFailure(testName, {2, static_cast<double>(edit), 1, 0});
+            break;
+        }
+    }
+
+    // 大地图上逐格砌墙，局部修复搜索不到另一侧时推迟到查询时重新标记，结果仍与重新标记一致
+    SqPlain large(160, 160, 1.0);
+    Components walled(large, 2);
+    std::uniform_int_distribution<int> large_coord(0, 159);
+    for (int wall = 0; wall < 4; ++wall) {
+        int fixed = large_coord(engine);
+        for (int k = 0; k < 160; ++k) {
+            Intex cell = wall % 2 == 0 ? Intex(fixed, k) : Intex(k, fixed);
+            large.map[cell.x][cell.y] = std::numeric_limits<double>::infinity();
+            walled.update(large, cell);
+            if (k % 53 == 0 && !same_partition(large, walled)) {
+                framework.addFailure(testName, {3, static_cast<double>(wall * 160 + k), 1, 0});
+            }
+        }
+        for (int edit = 0; edit < 40; ++edit) {
+            Intex cell(large_coord(engine), large_coord(engine));
+            large.map[cell.x][cell.y] = percent(engine) < 50 ? 1.0 : std::numeric_limits<double>::infinity();
+            walled.update(large, cell);
+        }
+        if (!same_partition(large, walled)) {
+            framework.addFailure(testName, {3, static_cast<double>(wall), 1, 0});
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "component_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("component_test: 通过所有测试用例");
+}
+
+TEST(reachable_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "可达性测试";
+
+    framework.info("reachable_test: 开始测试地面可达性");
+
+    Ground ground(20, 20);
+    if (!ground.reachable(Intex(0, 0), Intex(19, 19))) {
+        framework.addFailure(testName, {0, 0, 1, 0});
+    }
+
+    // 用一堵墙把地图分成左右两半
+    for (int x = 0; x < 20; ++x) {
+        ground.set_unit(x, 10, true);
+    }
+    if (ground.reachable(Intex(0, 0), Intex(19, 19)) || !ground.obstacle(5, 10)) {
+        framework.addFailure(testName, {1, 0, 0, 1});
+    }
+    if (!a_star_search(ground, Intex(0, 0), Intex(19, 19)).empty()) {
+        framework.addFailure(testName, {2, 0, 0, 1});
+    }
+    if (!ground.reachable(Intex(0, 0), Intex(19, 0))) {
+        framework.addFailure(testName, {3, 0, 1, 0});
+    }
+
+    // 打开一个缺口后重新连通
+    ground.set_unit(7, 10, false);
+    if (!ground.reachable(Intex(0, 0), Intex(19, 19))) {
+        framework.addFailure(testName, {4, 0, 1, 0});
+    }
+    auto path = a_star_search(ground, Intex(0, 0), Intex(19, 19));
+    bool crosses = std::find(path.begin(), path.end(), Intex(7, 10)) != path.end();
+    if (path.empty() || path.back() != Intex(19, 19) || !crosses) {
+        framework.addFailure(testName, {5, 0, 1, 0});
+    }
+
+    // 障碍格子自身不可达
+    if (ground.reachable(Intex(0, 10), Intex(0, 0))) {
+        framework.addFailure(testName, {6, 0, 0, 1});
+    }
+
+    // 封堵过的格子重新开放时不能经由旧集合连通已断开的区域
+    Ground strip(2, 5);
+    for (int y = 0; y < 5; ++y) {
+        strip.set_unit(1, y, true);
+    }
+    for (int y : {3, 2, 1}) {
+        strip.set_unit(0, y, true);
+    }
+    for (int y : {4, 3, 2}) {
+        strip.set_unit(1, y, false);
+    }
+    strip.set_unit(0, 2, false);
+    if (strip.reachable(Intex(0, 0), Intex(0, 4)) || !strip.reachable(Intex(0, 2), Intex(0, 4))) {
+        framework.addFailure(testName, {7, 0, 0, 1});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "reachable_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("reachable_test: 通过所有测试用例");
+}
+
+TEST(bitmap_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "障碍位图测试";
+
+    framework.info("bitmap_test: 开始测试障碍位图");
+
+    // 列数跨越多个64位字
+    std::mt19937 engine(41);
+    std::uniform_int_distribution<int> percent(0, 99);
+    Bitmap bitmap(37, 150);
+    std::vector<std::vector<bool>> cells(37, std::vector<bool>(150, false));
+    for (int x = 0; x < 37; ++x) {
+        for (int y = 0; y < 150; ++y) {
+            if (percent(engine) < 20) {
+                bitmap.set(x, y, true);
+                cells[x][y] = true;
+            }
+        }
+    }
+
+    std::uniform_int_distribution<int> row(-3, 39);
+    std::uniform_int_distribution<int> col(-5, 154);
+    for (int trial = 0; trial < 200; ++trial) {
+        int x0 = row(engine), x1 = row(engine), y0 = col(engine), y1 = col(engine);
+        int expected = 0;
+        bool any_expected = false;
+        for (int x = std::max(x0, 0); x <= std::min(x1, 36); ++x) {
+            for (int y = std::max(y0, 0); y <= std::min(y1, 149); ++y) {
+                expected += cells[x][y];
+            }
+        }
+        for (int y = std::max(y0, 0); x0 >= 0 && x0 < 37 && y <= std::min(y1, 149); ++y) {
+            any_expected = any_expected || cells[x0][y];
+        }
+        if (bitmap.count(x0, y0, x1, y1) != expected) {
+            framework.addFailure(testName, {0, static_cast<double>(trial), static_cast<double>(expected), static_cast<double>(bitmap.count(x0, y0, x1, y1))});
+        }
+        if (bitmap.any(x0, y0, y1) != any_expected) {
+            framework.addFailure(testName, {1, static_cast<double>(trial), static_cast<double>(any_expected), static_cast<double>(!any_expected)});
+        }
+    }
+
+    // 视线：水平、竖直与斜线
+    Bitmap open(10, 10);
+    open.set(5, 5, true);
+    std::vector<std::tuple<Intex, Intex, bool>> lines = {
+        {Intex(5, 0), Intex(5, 9), false},
+        {Intex(4, 0), Intex(4, 9), true},
+        {Intex(0, 5), Intex(9, 5), false},
+        {Intex(0, 0), Intex(9, 9), false},
+        {Intex(0, 1), Intex(8, 9), true},
+        {Intex(0, 0), Intex(9, 3), true},
+        {Intex(2, 3), Intex(8, 7), false},
+        {Intex(0, 0), Intex(10, 0), false}
+    };
+    for (size_t i = 0; i < lines.size(); ++i) {
+        bool expected = std::get<2>(lines[i]);
+        if (open.sight(std::get<0>(lines[i]), std::get<1>(lines[i])) != expected ||
+            open.sight(std::get<1>(lines[i]), std::get<0>(lines[i])) != expected) {
+            framework.addFailure(testName, {2, static_cast<double>(i), static_cast<double>(expected), static_cast<double>(!expected)});
+        }
+    }
+
+    // 地面修改后位图保持同步，位图版本的edge_allowed与逐格判断一致
+    Ground ground(30, 30);
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 30; ++y) {
+            ground.map[x][y] = 28.0 + (x * 7 + y * 13) % 5;
+        }
+    }
+    ground.map[3][4] = std::numeric_limits<double>::infinity();
+    ground.touch();
+    ground.set_unit(10, 12, true);
+    if (!ground.obstacle(3, 4) || !ground.obstacle(10, 12) || ground.obstacles().count(0, 0, 29, 29) != 2) {
+        framework.addFailure(testName, {3, 0, 2, static_cast<double>(ground.obstacles().count(0, 0, 29, 29))});
+    }
+    for (int x = -1; x <= 30; ++x) {
+        for (int y = -1; y <= 30; ++y) {
+            if (ground.edge_allowed(Intex(x, y)) != ground.map.edge_allowed(Intex(x, y))) {
+                framework.addFailure(testName, {4, static_cast<double>(x * 32 + y), 1, 0});
+            }
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "bitmap_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("bitmap_test: 通过所有测试用例");
+}
+
+/**
+ * @brief 逐个障碍求最近距离，作为距离场的参考结果
+ */
+static double nearest_obstacle(const Bitmap& bitmap, int x, int y) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < bitmap.rows(); ++i) {
+        for (int j = 0; j < bitmap.cols(); ++j) {
+            if (bitmap.test(i, j)) {
+                best = std::min(best, std::hypot(i - x, j - y));
+            }
+        }
+    }
+    return best;
+}
+
+TEST(clearance_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "距离场测试";
+
+    framework.info("clearance_test: 开始测试障碍距离场");
+
+    std::mt19937 engine(43);
+    std::uniform_int_distribution<int> percent(0, 99);
+    Bitmap bitmap(40, 70);
+    for (int x = 0; x < 40; ++x) {
+        for (int y = 0; y < 70; ++y) {
+            bitmap.set(x, y, percent(engine) < 3);
+        }
+    }
+
+    auto compare = [&](const Clearance& field, int code) {
+        for (int x = 0; x < 40; ++x) {
+            for (int y = 0; y < 70; ++y) {
+                double expected = nearest_obstacle(bitmap, x, y);
+                double actual = field.distance(Intex(x, y));
+                if (!(expected == actual || std::abs(expected - actual) < 1e-9)) {
+                    framework.addFailure(testName, {static_cast<double>(code), static_cast<double>(x * 70 + y), expected, actual});
+                    return;
+                }
+            }
+        }
+    };
+
+    Clearance empty_field(Bitmap(5, 5), 1);
+    if (empty_field.distance(Intex(2, 2)) != std::numeric_limits<double>::infinity()) {
+        framework.addFailure(testName, {0, 0, std::numeric_limits<double>::infinity(), empty_field.distance(Intex(2, 2))});
+    }
+    for (int threads : {1, 3}) {
+        compare(Clearance(bitmap, threads), threads);
+    }
+
+    // 增加与移除障碍后的增量更新
+    Clearance field(bitmap, 2);
+    std::uniform_int_distribution<int> row(0, 39);
+    std::uniform_int_distribution<int> col(0, 69);
+    for (int edit = 0; edit < 30; ++edit) {
+        Intex cell(row(engine), col(engine));
+        bitmap.set(cell.x, cell.y, !bitmap.test(cell.x, cell.y));
+        field.update(bitmap, cell);
+    }
+    compare(field, 4);
+
+    // 保持距离的路径与足部检查
+    Ground ground(20, 20);
+    for (int x = 0; x < 14; ++x) {
+        ground.set_unit(x, 10, true);
+    }
+    auto path = a_star_search(ground, Intex(0, 0), Intex(0, 19), 3.0);
+    if (path.empty() || path.front() != Intex(0, 0) || path.back() != Intex(0, 19)) {
+        framework.addFailure(testName, {5, 0, 1, 0});
+    }
+    for (const auto& cell : path) {
+        if (ground.clearance().distance(cell) < 3.0) {
+            framework.addFailure(testName, {5, 1, 3.0, ground.clearance().distance(cell)});
+            break;
+        }
+    }
+    if (!a_star_search(ground, Intex(19, 0), Intex(19, 19), 7.0).empty()) {
+        framework.addFailure(testName, {5, 3, 0, 1});
+    }
+
+    Foot near(SqDot(5, 7), 0.0, 4.0, 2.0);
+    Foot away(SqDot(5, 3), 0.0, 4.0, 2.0);
+    if (near.clear(ground, 2.5) || !away.clear(ground, 2.5)) {
+        framework.addFailure(testName, {6, 0, 1, 0});
+    }
+
+    // 不在整数格子上的足部与逐格检查一致，越过地图边界的足部被拒绝
+    Ground open(20, 20);
+    Foot edge(SqDot(1, 10), 0.0, 4.0, 2.0);
+    if (edge.clear(open, 0.0)) {
+        framework.addFailure(testName, {7, 0, 0, 1});
+    }
+    std::uniform_real_distribution<double> coord(2.0, 17.0);
+    std::uniform_real_distribution<double> turn(0.0, M_PI);
+    std::uniform_real_distribution<double> need(0.0, 6.0);
+    for (int trial = 0; trial < 2000; ++trial) {
+        Foot foot(SqDot(coord(engine), coord(engine)), turn(engine), 3.0, 1.5);
+        double margin = need(engine);
+        bool expected = true;
+        for (const auto& point : foot.cover()) {
+            if (!ground.is_valid(point) || !ground.clearance().clear(Intex(point.x_index(), point.y_index()), margin)) {
+                expected = false;
+                break;
+            }
+        }
+        if (foot.clear(ground, margin) != expected) {
+            framework.addFailure(testName, {7, static_cast<double>(trial), static_cast<double>(expected), static_cast<double>(!expected)});
+            break;
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "clearance_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("clearance_test: 通过所有测试用例");
+}
+
+TEST(erosion_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "腐蚀测试";
+
+    framework.info("erosion_test: 开始测试足部腐蚀位图");
+
+    std::mt19937 engine(44);
+    std::uniform_int_distribution<int> percent(0, 99);
+    Bitmap bitmap(30, 45);
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 45; ++y) {
+            bitmap.set(x, y, percent(engine) < 4);
+        }
+    }
+
+    // 逐个枚举足部覆盖的格子作为参考结果
+    for (int threads : {1, 3}) {
+        Erosion erosion(bitmap, 5.0, 3.0, 8, threads);
+        if (erosion.headings() != 8) {
+            framework.addFailure(testName, {0, static_cast<double>(threads), 8, static_cast<double>(erosion.headings())});
+        }
+        for (int h = 0; h < erosion.headings(); ++h) {
+            bool mismatch = false;
+            for (int x = 0; x < 30 && !mismatch; ++x) {
+                for (int y = 0; y < 45 && !mismatch; ++y) {
+                    bool expected = true;
+                    for (const auto& point : Foot(SqDot(x, y), erosion.angle(h), 5.0, 3.0).cover()) {
+                        int px = point.x_index();
+                        int py = point.y_index();
+                        if (px < 0 || px >= 30 || py < 0 || py >= 45 || bitmap.test(px, py)) {
+                            expected = false;
+                            break;
+                        }
+                    }
+                    if (erosion.fits(Intex(x, y), h) != expected) {
+                        framework.addFailure(testName, {static_cast<double>(threads), static_cast<double>(h * 10000 + x * 45 + y),
+                                                        static_cast<double>(expected), static_cast<double>(!expected)});
+                        mismatch = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // 朝向量化，rz与rz + π等价
+    Erosion erosion(Bitmap(10, 10), 3.0, 1.0, 4, 1);
+    if (erosion.heading(M_PI / 4 + 0.1) != 1 || erosion.heading(M_PI) != 0 || erosion.heading(-M_PI / 4) != 3) {
+        framework.addFailure(testName, {4, 0, 1, static_cast<double>(erosion.heading(M_PI / 4 + 0.1))});
+    }
+    if (!erosion.fits(SqDot(5.0, 5.0), 0.0) || erosion.fits(SqDot(0.0, 5.0), 0.0) || erosion.fits(Intex(5, 5), 4)) {
+        framework.addFailure(testName, {5, 0, 1, 0});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "erosion_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("erosion_test: 通过所有测试用例");
+}
+
+TEST(plane_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "平面拟合测试";
+
+    framework.info("plane_test: 开始测试最小二乘平面拟合");
+
+    // 精确平面上的点，两种方式都应还原平面
+    Ground ground(30, 30);
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 30; ++y) {
+            ground.map[x][y] = 0.3 * x - 0.2 * y + 5.0;
+        }
+    }
+    ground.touch();
+    Foot foot(SqDot(12, 14), 0.6, 5.0, 3.0);
+    auto area = foot.cover();
+    FootSpan spans[footprint_rows];
+    int rows = foot.spans(spans, footprint_rows);
+    for (const CuPlain& plane : {ground.trip(area, TripMode::LeastSquares), ground.trip(spans, rows)}) {
+        if (std::abs(plane.A + 0.3) > 1e-9 || std::abs(plane.B - 0.2) > 1e-9 ||
+            std::abs(plane.C - 1.0) > 1e-12 || std::abs(plane.D + 5.0) > 1e-9) {
+            framework.addFailure(testName, {1, 0, 0.3, -plane.A});
+        }
+    }
+    double expected_angle = std::atan(std::hypot(0.3, 0.2));
+    if (std::abs(ground.stand_angle(area, TripMode::LeastSquares) - expected_angle) > 1e-9) {
+        framework.addFailure(testName, {1, 1, expected_angle, ground.stand_angle(area, TripMode::LeastSquares)});
+    }
+
+    // 随机高度下，按行前缀和得到的平面与逐点累计的平面一致，并满足正规方程
+    std::mt19937 engine(73);
+    std::uniform_real_distribution<double> height(0.0, 4.0);
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 30; ++y) {
+            ground.map[x][y] = height(engine);
+        }
+    }
+    ground.touch();
+    CuPlain direct = ground.trip(area, TripMode::LeastSquares);
+    CuPlain summed = ground.trip(spans, rows);
+    if (std::abs(direct.A - summed.A) > 1e-9 || std::abs(direct.B - summed.B) > 1e-9 || std::abs(direct.D - summed.D) > 1e-9) {
+        framework.addFailure(testName, {2, 0, direct.A, summed.A});
+    }
+    double rx = 0.0, ry = 0.0, r1 = 0.0;
+    for (const auto& point : area) {
+        double residual = ground.map[point.x][point.y] + direct.A * point.x + direct.B * point.y + direct.D;
+        rx += residual * point.x;
+        ry += residual * point.y;
+        r1 += residual;
+    }
+    if (std::abs(rx) > 1e-6 || std::abs(ry) > 1e-6 || std::abs(r1) > 1e-6) {
+        framework.addFailure(testName, {2, 1, 0, rx});
+    }
+
+    // 修改后前缀和同步，足部内有障碍时无法拟合也不能站立，越界与点数不足时返回默认平面
+    ground.set_unit(12, 14, false);
+    PlaneMoments moments;
+    for (const auto& point : area) {
+        moments.add(point.x, point.y, ground.map[point.x][point.y]);
+    }
+    CuPlain edited = ground.trip(spans, rows);
+    if (std::abs(moments.fit().A - edited.A) > 1e-9) {
+        framework.addFailure(testName, {3, 0, moments.fit().A, edited.A});
+    }
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 30; ++y) {
+            ground.map[x][y] = 1.0;
+        }
+    }
+    ground.touch();
+    ground.set_unit(12, 14, true);
+    if (ground.trip(spans, rows).C != 0.0 || ground.trip(area, TripMode::LeastSquares).C != 0.0 ||
+        ground.stand_check(spans, rows)) {
+        framework.addFailure(testName, {3, 1, 0, ground.trip(spans, rows).C});
+    }
+    FootSpan outside[1] = {{0, -1, 3}};
+    CuPlain none = ground.trip(outside, 1);
+    if (none.A != 0.0 || none.B != 0.0 || none.C != 0.0 || ground.trip({SqDot(1, 1), SqDot(2, 2)}, TripMode::LeastSquares).C != 0.0) {
+        framework.addFailure(testName, {4, 0, 0, none.C});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "plane_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("plane_test: 通过所有测试用例");
+}
+
+TEST(support_plane_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "支撑平面测试";
+
+    framework.info("support_plane_test: 开始测试凸包支撑平面");
+
+    Ground ground(30, 30);
+    std::mt19937 engine(79);
+    std::uniform_real_distribution<double> height(0.0, 3.0);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    for (int trial = 0; trial < 30; ++trial) {
+        for (int x = 0; x < 30; ++x) {
+            for (int y = 0; y < 30; ++y) {
+                ground.map[x][y] = height(engine);
+            }
+        }
+        ground.touch();
+        auto area = Foot(SqDot(15, 15), angle(engine), 5.0, 3.0).cover();
+        CuPlain plane = ground.trip(area, TripMode::Convex);
+        if (plane.C != 1.0) {
+            framework.addFailure(testName, {1, static_cast<double>(trial), 1, plane.C});
+            continue;
+        }
+
+        // 平面不低于任何点
+        double cx = 0.0, cy = 0.0;
+        for (const auto& point : area) {
+            double z = ground.map[point.x][point.y];
+            if (z + plane.A * point.x + plane.B * point.y + plane.D > 1e-7) {
+                framework.addFailure(testName, {2, static_cast<double>(trial), 0, z});
+                break;
+            }
+            cx += point.x;
+            cy += point.y;
+        }
+        cx /= area.size();
+        cy /= area.size();
+
+        // 枚举三点确定的平面，重心处高度的最小值与结果一致
+        double best = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < area.size(); ++i) {
+            for (size_t j = i + 1; j < area.size(); ++j) {
+                for (size_t k = j + 1; k < area.size(); ++k) {
+                    std::array<CuDot, 3> three = {
+                        CuDot(area[i].x, area[i].y, ground.map[area[i].x][area[i].y]),
+                        CuDot(area[j].x, area[j].y, ground.map[area[j].x][area[j].y]),
+                        CuDot(area[k].x, area[k].y, ground.map[area[k].x][area[k].y])};
+                    CuPlain candidate;
+                    if (!candidate.define_plaine(three) || std::abs(candidate.C) < 1e-12) continue;
+                    bool above = true;
+                    for (const auto& point : area) {
+                        double z = -(candidate.A * point.x + candidate.B * point.y + candidate.D) / candidate.C;
+                        if (ground.map[point.x][point.y] > z + 1e-9) {
+                            above = false;
+                            break;
+                        }
+                    }
+                    if (above) {
+                        best = std::min(best, -(candidate.A * cx + candidate.B * cy + candidate.D) / candidate.C);
+                    }
+                }
+            }
+        }
+        double actual = -(plane.A * cx + plane.B * cy + plane.D);
+        if (std::abs(best - actual) > 1e-7) {
+            framework.addFailure(testName, {3, static_cast<double>(trial), best, actual});
+        }
+    }
+
+    // 平面上的点恰好还原该平面，共线的点无法确定平面
+    CuDot flat[4] = {CuDot(0, 0, 1.0), CuDot(2, 0, 2.0), CuDot(0, 2, 0.0), CuDot(2, 2, 1.0)};
+    CuPlain plane = support_plane(flat, 4);
+    if (std::abs(plane.A + 0.5) > 1e-9 || std::abs(plane.B - 0.5) > 1e-9 || std::abs(plane.D + 1.0) > 1e-9) {
+        framework.addFailure(testName, {4, 0, -0.5, plane.A});
+    }
+    CuDot line[3] = {CuDot(0, 0, 1.0), CuDot(1, 1, 2.0), CuDot(2, 2, 0.0)};
+    if (support_plane(line, 3).C != 0.0) {
+        framework.addFailure(testName, {5, 0, 0, support_plane(line, 3).C});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "support_plane_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("support_plane_test: 通过所有测试用例");
+}
+
+TEST(slope_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "坡度表测试";
+
+    framework.info("slope_test: 开始测试坡度表");
+
+    // 平面上每格（含边界）的坡度都等于平面坡度，单格梯度以float保存
+    Ground ground(25, 25);
+    for (int x = 0; x < 25; ++x) {
+        for (int y = 0; y < 25; ++y) {
+            ground.map[x][y] = 0.4 * x + 0.1 * y;
+        }
+    }
+    ground.touch();
+    double expected = std::atan(std::hypot(0.4, 0.1));
+    for (int x = 0; x < 25; x += 6) {
+        for (int y = 0; y < 25; y += 4) {
+            if (std::abs(ground.slope().angle(Intex(x, y)) - expected) > 1e-6) {
+                framework.addFailure(testName, {1, static_cast<double>(x * 25 + y), expected, ground.slope().angle(Intex(x, y))});
+            }
+        }
+    }
+    CuDot normal = ground.slope().normal(Intex(10, 10));
+    if (std::abs(normal.x * 0.1 - normal.y * 0.4) > 1e-12 || normal.z <= 0.0) {
+        framework.addFailure(testName, {2, 0, 0, normal.x});
+    }
+
+    // 随机高度下与3×3邻域内非障碍格子的最小二乘拟合一致，障碍格子无法拟合，修改后增量更新与重新计算一致
+    std::mt19937 engine(83);
+    std::uniform_real_distribution<double> height(0.0, 2.0);
+    for (int x = 0; x < 25; ++x) {
+        for (int y = 0; y < 25; ++y) {
+            ground.map[x][y] = height(engine);
+        }
+    }
+    ground.touch();
+    ground.set_unit(12, 12, true);
+    ground.set_unit(0, 3, true);
+    SlopeMap fresh(ground.map, 3);
+    for (int x = 0; x < 25; ++x) {
+        for (int y = 0; y < 25; ++y) {
+            PlaneMoments moments;
+            for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, 24); ++nx) {
+                for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, 24); ++ny) {
+                    if (ground.edge_allowed(Intex(nx, ny))) {
+                        moments.add(nx, ny, ground.map[nx][ny]);
+                    }
+                }
+            }
+            double want = ground.edge_allowed(Intex(x, y)) ? moments.fit().normal_angle() : INFINITY;
+            double got = ground.slope().angle(Intex(x, y));
+            bool same = std::isinf(want) ? std::isinf(got) && std::isinf(fresh.angle(Intex(x, y))) :
+                std::abs(want - got) <= 1e-6 && std::abs(fresh.angle(Intex(x, y)) - got) <= 1e-12;
+            if (!same) {
+                framework.addFailure(testName, {3, static_cast<double>(x * 25 + y), want, got});
+            }
+        }
+    }
+
+    // 长行末端的单格梯度不受前面大梯度累积的前缀和影响
+    SqPlain strip(3, 4000, 0.0);
+    for (int y = 0; y < 4000; ++y) {
+        strip[1][y] = y < 2000 ? 0.0 : 1e-6;
+        strip[2][y] = y < 2000 ? 1e6 : 2e-6;
+    }
+    SlopeMap long_row(strip, 2);
+    double tiny = long_row.angle(Intex(1, 3000));
+    if (std::abs(tiny - std::atan(1e-6)) > 1e-12) {
+        framework.addFailure(testName, {8, 0, std::atan(1e-6), tiny});
+    }
+
+    // 覆盖障碍的足部区域无法求平均坡度
+    FootSpan blocked_spans[footprint_rows];
+    int blocked_rows = Foot(SqDot(12, 11), 0.0, 3.0, 3.0).spans(blocked_spans, footprint_rows);
+    if (!std::isinf(ground.slope().mean_angle(blocked_spans, blocked_rows))) {
+        framework.addFailure(testName, {7, 0, INFINITY, ground.slope().mean_angle(blocked_spans, blocked_rows)});
+    }
+
+    // 站立角度判断：与足部覆盖格子的最小二乘拟合一致
+    for (double degrees : {10.0, 19.5, 20.5, 30.0}) {
+        double gradient = std::tan(degrees * M_PI / 180.0);
+        for (int x = 0; x < 25; ++x) {
+            for (int y = 0; y < 25; ++y) {
+                ground.map[x][y] = gradient * x;
+            }
+        }
+        ground.touch();
+        FootSpan spans[footprint_rows];
+        int rows = Foot(SqDot(12, 12), 0.3, 5.0, 3.0).spans(spans, footprint_rows);
+        if (ground.stand_check(spans, rows) != (degrees < 20.0)) {
+            framework.addFailure(testName, {4, degrees, degrees < 20.0 ? 1.0 : 0.0, degrees < 20.0 ? 0.0 : 1.0});
+        }
+    }
+
+    // 台阶地形上梯度表的平均坡度与拟合平面差别很大，判断仍须与逐格拟合一致
+    for (int x = 0; x < 25; ++x) {
+        for (int y = 0; y < 25; ++y) {
+            ground.map[x][y] = (0.9 + 0.2 * (x / 5)) * (y / 4);
+        }
+    }
+    ground.touch();
+    double limit = M_PI * 20.0 / 180.0;
+    int passed = 0;
+    for (int k = 0; k < 200; ++k) {
+        FootSpan spans[footprint_rows];
+        int rows = Foot(SqDot(5 + k % 15, 5 + (k / 15) % 15), k * 0.17, 5.0, 3.0).spans(spans, footprint_rows);
+        PlaneMoments moments;
+        for (int r = 0; r < rows; ++r) {
+            for (int y = spans[r].y0; y <= spans[r].y1; ++y) {
+                moments.add(spans[r].x, y, ground.map[spans[r].x][y]);
+            }
+        }
+        bool want = moments.fit().normal_angle() <= limit;
+        passed += want ? 1 : 0;
+        if (ground.stand_check(spans, rows, limit) != want) {
+            framework.addFailure(testName, {5, static_cast<double>(k), want ? 1.0 : 0.0, want ? 0.0 : 1.0});
+        }
+    }
+    if (passed == 0 || passed == 200) {
+        framework.addFailure(testName, {6, 0, 1, static_cast<double>(passed)});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "slope_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("slope_test: 通过所有测试用例");
+}
+
+TEST(foothold_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "可落足位图测试";
+
+    framework.info("foothold_test: 开始测试可落足位图");
+
+    // 左半部分缓坡，右半部分陡坡，另有少量障碍
+    std::mt19937 engine(46);
+    std::uniform_int_distribution<int> percent(0, 99);
+    Ground ground(30, 40);
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 40; ++y) {
+            ground.map[x][y] = y < 20 ? 0.1 * y : 2.0 + 0.6 * (y - 20);
+            if (percent(engine) < 3) {
+                ground.map[x][y] = -1.0;
+            }
+        }
+    }
+    ground.touch();
+
+    double limit = M_PI * 20.0 / 180.0;
+    for (int threads : {1, 3}) {
+        Footholds footholds(ground, 5.0, 3.0, 8, limit, threads);
+        int feasible = 0;
+        for (int h = 0; h < footholds.headings(); ++h) {
+            for (int x = 0; x < 30; ++x) {
+                for (int y = 0; y < 40; ++y) {
+                    FootSpan spans[footprint_rows];
+                    int count = Foot(SqDot(x, y), footholds.angle(h), 5.0, 3.0).spans(spans, footprint_rows);
+                    bool expected = count > 0;
+                    for (int k = 0; k < count && expected; ++k) {
+                        expected = ground.is_valid(spans[k].x, spans[k].y0) && ground.is_valid(spans[k].x, spans[k].y1) &&
+                                   !ground.obstacles().any(spans[k].x, spans[k].y0, spans[k].y1);
+                    }
+                    expected = expected && ground.stand_check(spans, count, limit);
+                    feasible += expected ? 1 : 0;
+                    if (footholds.fits(Intex(x, y), h) != expected) {
+                        framework.addFailure(testName, {static_cast<double>(threads), static_cast<double>(h * 10000 + x * 40 + y),
+                                                        static_cast<double>(expected), static_cast<double>(!expected)});
+                    }
+                }
+            }
+        }
+        if (feasible == 0 || feasible == footholds.headings() * 30 * 40) {
+            framework.addFailure(testName, {2, static_cast<double>(threads), 1, static_cast<double>(feasible)});
+        }
+    }
+
+    // 台阶地形上抽查置位与未置位的格子，与覆盖格子逐个累计的最小二乘拟合一致
+    Ground terraced(30, 40);
+    for (int x = 0; x < 30; ++x) {
+        for (int y = 0; y < 40; ++y) {
+            terraced.map[x][y] = (0.9 + 0.2 * (x / 6)) * (y / 4);
+        }
+    }
+    terraced.touch();
+    Footholds stepped(terraced, 5.0, 3.0, 8, limit, 2);
+    int set_bits = 0;
+    int unset_bits = 0;
+    for (int cell = 0; cell < 8 * 30 * 40; cell += 7) {
+        int h = cell / 1200;
+        int x = cell % 1200 / 40;
+        int y = cell % 40;
+        FootSpan spans[footprint_rows];
+        int count = Foot(SqDot(x, y), stepped.angle(h), 5.0, 3.0).spans(spans, footprint_rows);
+        PlaneMoments moments;
+        bool inside = count > 0;
+        for (int k = 0; k < count && inside; ++k) {
+            for (int cy = spans[k].y0; cy <= spans[k].y1 && inside; ++cy) {
+                inside = terraced.is_valid(spans[k].x, cy);
+                if (inside) {
+                    moments.add(spans[k].x, cy, terraced.map[spans[k].x][cy]);
+                }
+            }
+        }
+        CuPlain plane = moments.fit();
+        bool expected = inside && plane.C != 0.0 && plane.normal_angle() <= limit;
+        bool actual = stepped.fits(Intex(x, y), h);
+        set_bits += actual ? 1 : 0;
+        unset_bits += actual ? 0 : 1;
+        if (actual != expected) {
+            framework.addFailure(testName, {9, static_cast<double>(cell), static_cast<double>(expected), static_cast<double>(actual)});
+        }
+    }
+    if (set_bits == 0 || unset_bits == 0) {
+        framework.addFailure(testName, {10, static_cast<double>(set_bits), 1, static_cast<double>(unset_bits)});
+    }
+
+    // 持久化后逐位一致，地图修改后指纹不再匹配
+    Footholds built(ground, 5.0, 3.0, 8, limit, 2);
+    std::string filename = IOManager::get_instance().build_path("log/foothold_test.bin");
+    Footholds loaded;
+    if (!built.save(filename) || !loaded.load(filename) || !loaded.matches(ground) ||
+        loaded.headings() != 8 || loaded.length() != 5.0 || loaded.width() != 3.0 || loaded.limit() != limit) {
+        framework.addFailure(testName, {3, 0, 1, 0});
+    } else {
+        for (int h = 0; h < 8; ++h) {
+            for (int x = 0; x < 30; ++x) {
+                for (int y = 0; y < 40; ++y) {
+                    if (loaded.fits(Intex(x, y), h) != built.fits(Intex(x, y), h)) {
+                        framework.addFailure(testName, {4, static_cast<double>(h * 10000 + x * 40 + y), 1, 0});
+                    }
+                }
+            }
+        }
+    }
+    if (loaded.load(IOManager::get_instance().build_path("log/foothold_missing.bin"))) {
+        framework.addFailure(testName, {5, 0, 0, 1});
+    }
+
+    // 文件头的尺寸与数据长度不符时拒绝读取，原位图保持不变
+    std::vector<char> bytes;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto corrupt = [&](int field, int32_t value, int extra) {
+        std::vector<char> changed = bytes;
+        std::memcpy(changed.data() + 8 + field * sizeof(int32_t), &value, sizeof(value));
+        changed.resize(changed.size() + extra, 0);
+        std::string broken = IOManager::get_instance().build_path("log/foothold_broken.bin");
+        std::ofstream out(broken, std::ios::binary);
+        out.write(changed.data(), static_cast<std::streamsize>(changed.size()));
+        out.close();
+        return loaded.load(broken);
+    };
+    std::vector<std::tuple<int, int32_t, int>> broken_cases = {
+        {0, 29, 0}, {0, 31, 0}, {1, 200, 0}, {2, 7, 0}, {2, 9, 0}, {0, 30, 8}, {0, 30, -8}, {0, 0, 0}
+    };
+    for (size_t k = 0; k < broken_cases.size(); ++k) {
+        if (corrupt(std::get<0>(broken_cases[k]), std::get<1>(broken_cases[k]), std::get<2>(broken_cases[k]))) {
+            framework.addFailure(testName, {7, static_cast<double>(k), 0, 1});
+        }
+    }
+    if (loaded.rows() != 30 || loaded.cols() != 40 || loaded.headings() != 8) {
+        framework.addFailure(testName, {8, 0, 1, 0});
+    }
+    ground.set_unit(15, 10, true);
+    if (loaded.matches(ground)) {
+        framework.addFailure(testName, {6, 0, 0, 1});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "foothold_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("foothold_test: 通过所有测试用例");
+}
+
+TEST(sampler_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "高度插值测试";
+
+    framework.info("sampler_test: 开始测试高度插值");
+
+    Ground ground(20, 30);
+    for (int x = 0; x < 20; ++x) {
+        for (int y = 0; y < 30; ++y) {
+            ground.map[x][y] = 0.3 * x - 0.2 * y + 10.0;
+        }
+    }
+    ground.touch();
+    HeightSampler sampler(ground.map, ground.obstacles());
+
+    // 线性地形上双线性处处精确，双三次在内部精确，格点上等于格子高度
+    std::mt19937 engine(49);
+    std::uniform_real_distribution<double> px(0.0, 19.0);
+    std::uniform_real_distribution<double> py(0.0, 29.0);
+    PointBatch points;
+    for (int k = 0; k < 200; ++k) {
+        double x = px(engine);
+        double y = py(engine);
+        points.push(x, y, 0.0);
+        double expected = 0.3 * x - 0.2 * y + 10.0;
+        if (!(std::abs(sampler.sample(x, y) - expected) <= 1e-9)) {
+            framework.addFailure(testName, {1, static_cast<double>(k), expected, sampler.sample(x, y)});
+        }
+        if (x >= 1.0 && x <= 18.0 && y >= 1.0 && y <= 28.0 &&
+            !(std::abs(sampler.sample(x, y, Interpolation::Bicubic) - expected) <= 1e-9)) {
+            framework.addFailure(testName, {2, static_cast<double>(k), expected, sampler.sample(x, y, Interpolation::Bicubic)});
+        }
+    }
+    for (auto mode : {Interpolation::Nearest, Interpolation::Bilinear, Interpolation::Bicubic}) {
+        if (sampler.sample(7.0, 11.0, mode) != ground.map[7][11] || sampler.sample(19.0, 29.0, mode) != ground.map[19][29]) {
+            framework.addFailure(testName, {3, static_cast<double>(static_cast<int>(mode)), ground.map[7][11], sampler.sample(7.0, 11.0, mode)});
+        }
+    }
+
+    // 批量结果与逐点一致
+    for (auto mode : {Interpolation::Nearest, Interpolation::Bilinear, Interpolation::Bicubic}) {
+        PointBatch batch = points;
+        if (sampler.sample(batch, mode) != batch.size()) {
+            framework.addFailure(testName, {4, static_cast<double>(static_cast<int>(mode)), static_cast<double>(batch.size()), 0});
+        }
+        for (int k = 0; k < batch.size(); ++k) {
+            if (batch.z[k] != sampler.sample(batch.x[k], batch.y[k], mode)) {
+                framework.addFailure(testName, {5, static_cast<double>(k), sampler.sample(batch.x[k], batch.y[k], mode), batch.z[k]});
+                break;
+            }
+        }
+    }
+
+    // 越界与障碍
+    ground.set_unit(10, 10, true);
+    if (!std::isnan(sampler.sample(-0.1, 3.0)) || !std::isnan(sampler.sample(5.0, 29.5)) || !std::isnan(sampler.sample(NAN, 3.0)) ||
+        !std::isnan(sampler.sample(9.5, 10.2)) || !std::isnan(sampler.sample(8.5, 10.0, Interpolation::Bicubic))) {
+        framework.addFailure(testName, {6, 0, 0, 1});
+    }
+    if (std::isnan(sampler.sample(9.0, 10.0)) || std::isnan(sampler.sample(10.0, 11.0, Interpolation::Bicubic))) {
+        framework.addFailure(testName, {7, 0, 1, 0});
+    }
+    double xs[3] = {1.0, 10.0, 2.5};
+    double ys[3] = {1.0, 10.0, 3.5};
+    double zs[3];
+    if (sampler.sample(xs, ys, 3, zs) != 2 || !std::isnan(zs[1])) {
+        framework.addFailure(testName, {8, 0, 2, zs[1]});
+    }
+
+    // 地图与位图尺寸不一致时视为空取样器
+    Bitmap stale(5, 5);
+    HeightSampler mismatched(ground.map, stale);
+    if (!mismatched.empty() || !std::isnan(mismatched.sample(1.0, 1.0)) || mismatched.sample(xs, ys, 3, zs) != 0) {
+        framework.addFailure(testName, {11, 0, 1, 0});
+    }
+
+    // 旋转后的足部拟合出精确的地形平面，压到障碍时拟合失败
+    CuPlain plane = ground.sample_trip(SqDot(5.3, 20.6), 0.7, 5.0, 3.0);
+    double expected = std::atan(std::hypot(0.3, 0.2));
+    if (!(std::abs(plane.normal_angle() - expected) <= 1e-9)) {
+        framework.addFailure(testName, {9, 0, expected, plane.normal_angle()});
+    }
+    CuPlain failed = ground.sample_trip(SqDot(10.2, 9.7), 0.7, 5.0, 3.0, 0.5, Interpolation::Bicubic);
+    if (failed.A != 0.0 || failed.B != 0.0 || failed.C != 0.0) {
+        framework.addFailure(testName, {10, 0, 0, failed.C});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "sampler_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("sampler_test: 通过所有测试用例");
+}
+
+TEST(swing_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "线段最大高度测试";
+
+    framework.info("swing_test: 开始测试线段最大高度");
+
+    std::mt19937 engine(50);
+    std::uniform_real_distribution<double> height(0.0, 5.0);
+    std::uniform_int_distribution<int> percent(0, 99);
+    Ground ground(40, 50);
+    for (int x = 0; x < 40; ++x) {
+        for (int y = 0; y < 50; ++y) {
+            ground.map[x][y] = percent(engine) < 2 ? -1.0 : height(engine);
+        }
+    }
+    ground.touch();
+    auto exact = [&ground](int x, int y) {
+        return ground.map.edge_allowed(Intex(x, y)) ? ground.map[x][y] : std::numeric_limits<double>::infinity();
+    };
+    // 表中高度向上取整到float
+    auto value = [&exact](int x, int y) {
+        double height = exact(x, y);
+        float stored = static_cast<float>(height);
+        return static_cast<double>(stored < height ? std::nextafter(stored, std::numeric_limits<float>::infinity()) : stored);
+    };
+
+    // 按行逐格扫描线段经过的格子作为参考结果
+    auto brute = [&](const Intex& from, const Intex& to) {
+        double best = -std::numeric_limits<double>::infinity();
+        double dx = to.x - from.x;
+        double dy = to.y - from.y;
+        for (int x = std::min(from.x, to.x); x <= std::max(from.x, to.x); ++x) {
+            double t0 = 0.0;
+            double t1 = 1.0;
+            if (dx != 0.0) {
+                t0 = std::max(std::min((x - 0.5 - from.x) / dx, (x + 0.5 - from.x) / dx), 0.0);
+                t1 = std::min(std::max((x - 0.5 - from.x) / dx, (x + 0.5 - from.x) / dx), 1.0);
+            }
+            double ya = std::min(from.y + t0 * dy, from.y + t1 * dy);
+            double yb = std::max(from.y + t0 * dy, from.y + t1 * dy);
+            for (int y = static_cast<int>(std::ceil(ya - 0.5 + 1e-9)); y <= static_cast<int>(std::floor(yb + 0.5 - 1e-9)); ++y) {
+                best = std::max(best, value(x, y));
+            }
+        }
+        return best;
+    };
+
+    std::uniform_int_distribution<int> px(0, 39);
+    std::uniform_int_distribution<int> py(0, 49);
+    for (int reach : {4, 64}) {
+        SwingTable table(ground.map, reach, 3);
+        for (int k = 0; k < 300; ++k) {
+            Intex from(px(engine), py(engine));
+            Intex to(px(engine), py(engine));
+            if (table.segment_max(from, to) != brute(from, to)) {
+                framework.addFailure(testName, {static_cast<double>(reach), static_cast<double>(k), brute(from, to), table.segment_max(from, to)});
+            }
+            int lo = std::min(from.y, to.y);
+            int hi = std::max(from.y, to.y);
+            double expected = -std::numeric_limits<double>::infinity();
+            for (int y = lo; y <= hi; ++y) {
+                expected = std::max(expected, value(from.x, y));
+            }
+            if (table.row_max(from.x, lo, hi) != expected) {
+                framework.addFailure(testName, {1, static_cast<double>(k), expected, table.row_max(from.x, lo, hi)});
+            }
+            // 取整只会抬高，越障判断不会放过真实高度更高的地形
+            if (table.height(from) < exact(from.x, from.y)) {
+                framework.addFailure(testName, {4, static_cast<double>(k), exact(from.x, from.y), table.height(from)});
+            }
+        }
+    }
+
+    // 修改后增量更新与重新建表一致，越界端点无法越过
+    SwingTable table(ground.map, 16);
+    ground.set_unit(20, 25, true);
+    ground.set_unit(3, 7, false);
+    table.update(ground.map, Intex(20, 25));
+    table.update(ground.map, Intex(3, 7));
+    SwingTable fresh(ground.map, 16);
+    for (int k = 0; k < 200; ++k) {
+        Intex from(px(engine), py(engine));
+        Intex to(px(engine), py(engine));
+        if (table.segment_max(from, to) != fresh.segment_max(from, to)) {
+            framework.addFailure(testName, {2, static_cast<double>(k), fresh.segment_max(from, to), table.segment_max(from, to)});
+        }
+    }
+    if (table.clears(Intex(20, 20), Intex(20, 30), 100.0) || table.clears(Intex(0, 0), Intex(-1, 3), 100.0) ||
+        !table.clears(Intex(3, 7), Intex(3, 7), 0.0)) {
+        framework.addFailure(testName, {3, 0, 0, 1});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "swing_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("swing_test: 通过所有测试用例");
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        // 设置工作目录
+        if (argc > 1) {
+            TestFramework::getInstance().setWorkingDirectory(argv[1]);
+        }
+        
+        TestFramework::getInstance().setLogFile("log/ground_test.log");
+        TestFramework::getInstance().info("=== 地面测试 ===");
+        
+        bool result = TestFramework::getInstance().runTests();
+        TestFramework::getInstance().info("=== 测试完成 ===");
+        
+        return result ? 0 : 1;
+    } catch (const std::exception& e) {
+        TestFramework::getInstance().error("测试执行出错: " + std::string(e.what()));
+        return 1;
+    }
+}
@@ -0,0 +1,227 @@
+#include "utils/test_framework.hpp"
+#include "utils/parallel.hpp"
+#include "utils/batch.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <random>
+#include <cmath>
+#include <stdexcept>
+
+TEST(parallel_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "线程池测试";
+
+    framework.info("parallel_test: 开始测试工作窃取线程池");
+
+    // 每个下标恰好被处理一次
+    for (int threads : {1, 3, 16}) {
+        std::vector<int> hits(1000, 0);
+        parallel_for(0, 1000, [&](int lo, int hi) {
+            for (int i = lo; i < hi; ++i) {
+                hits[i]++;
+            }
+        }, threads);
+        for (int i = 0; i < 1000; ++i) {
+            if (hits[i] != 1) {
+                framework.addFailure(testName, {1, static_cast<double>(threads), 1, static_cast<double>(hits[i])});
+                break;
+            }
+        }
+    }
+
+    // 二维分块覆盖整个区域
+    std::vector<int> cells(37 * 53, 0);
+    parallel_tiles(37, 53, 8, [&](int x0, int x1, int y0, int y1) {
+        for (int x = x0; x < x1; ++x) {
+            for (int y = y0; y < y1; ++y) {
+                cells[x * 53 + y]++;
+            }
+        }
+    });
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (cells[i] != 1) {
+            framework.addFailure(testName, {2, static_cast<double>(i), 1, static_cast<double>(cells[i])});
+            break;
+        }
+    }
+
+    // 任务内部再次提交并等待，不会死锁
+    std::atomic<int> leaves(0);
+    {
+        TaskGroup outer;
+        for (int i = 0; i < 8; ++i) {
+            outer.run([&]() {
+                TaskGroup inner;
+                for (int j = 0; j < 8; ++j) {
+                    inner.run([&]() {
+                        leaves++;
+                    });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+    }
+    if (leaves != 64) {
+        framework.addFailure(testName, {3, 0, 64, static_cast<double>(leaves.load())});
+    }
+
+    // 没有工作线程的线程池由等待者执行任务
+    ThreadPool idle(0);
+    int ran = 0;
+    {
+        TaskGroup group(idle);
+        for (int i = 0; i < 5; ++i) {
+            group.run([&]() {
+                ran++;
+            });
+        }
+    }
+    if (ran != 5 || idle.size() != 0) {
+        framework.addFailure(testName, {4, 0, 5, static_cast<double>(ran)});
+    }
+
+    // 任务抛出的异常由wait重新抛出，其余任务照常完成，任务组不会卡住
+    std::atomic<int> finished(0);
+    bool caught = false;
+    {
+        TaskGroup group;
+        for (int i = 0; i < 16; ++i) {
+            group.run([&, i]() {
+                if (i % 4 == 1) {
+                    throw std::runtime_error("task");
+                }
+                finished++;
+            });
+        }
+        try {
+            group.wait();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        group.wait();
+    }
+    if (!caught || finished != 12) {
+        framework.addFailure(testName, {6, 0, 12, static_cast<double>(finished.load())});
+    }
+
+    // 线程组中的线程同时运行，可以用屏障同步
+    Barrier barrier(4);
+    std::atomic<int> arrived(0);
+    std::vector<int> seen(4, 0);
+    parallel_team(4, [&](int rank) {
+        arrived++;
+        barrier.wait();
+        seen[rank] = arrived;
+    });
+    for (int rank = 0; rank < 4; ++rank) {
+        if (seen[rank] != 4) {
+            framework.addFailure(testName, {5, static_cast<double>(rank), 4, static_cast<double>(seen[rank])});
+        }
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "parallel_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("parallel_test: 通过所有测试用例");
+}
+
+TEST(batch_test) {
+    auto& framework = TestFramework::getInstance();
+    const std::string testName = "批量几何核函数测试";
+
+    framework.info("batch_test: 开始测试批量几何核函数");
+
+    std::mt19937 engine(48);
+    std::uniform_real_distribution<double> coord(-20.0, 20.0);
+    std::vector<CuPlain> planes = {CuPlain(0.3, -0.2, 1.0, -2.0), CuPlain(-1.5, 0.7, 0.4, 3.0), CuPlain(0.0, 0.0, 2.0, 0.0)};
+
+    // 各种长度覆盖向量部分与标量尾部，结果与逐点计算一致
+    for (int count : {0, 1, 3, 4, 7, 16, 37}) {
+        PointBatch points;
+        for (int i = 0; i < count; ++i) {
+            points.push(coord(engine), coord(engine), coord(engine));
+        }
+        // 恰好落在平面上的点
+        if (count > 2) {
+            points.z[1] = 2.0 - 0.3 * points.x[1] + 0.2 * points.y[1];
+        }
+        for (size_t p = 0; p < planes.size(); ++p) {
+            const CuPlain& plane = planes[p];
+            std::vector<double> distances(count);
+            std::vector<int8_t> sides(count);
+            plane_distances(plane, points, distances.data());
+            plane_sides(plane, points, sides.data());
+
+            double error = 0.0;
+            double farthest = 0.0;
+            int expected_index = -1;
+            for (int i = 0; i < count; ++i) {
+                CuDot dot(points.x[i], points.y[i], points.z[i]);
+                error += plane.distance(dot);
+                CuPos pos = plane.get_pos(dot);
+                int side = pos == CuPos::Above ? 1 : (pos == CuPos::Below ? -1 : 0);
+                if (side != sides[i] || std::abs(std::abs(distances[i]) - plane.distance(dot)) > 1e-9) {
+                    framework.addFailure(testName, {1, static_cast<double>(count * 100 + p), static_cast<double>(side), static_cast<double>(sides[i])});
+                }
+                if (side > 0 && (distances[i] < 0.0)) {
+                    framework.addFailure(testName, {2, static_cast<double>(count * 100 + p), 1, distances[i]});
+                }
+                if (pos == CuPos::Above && plane.distance(dot) > farthest) {
+                    farthest = plane.distance(dot);
+                    expected_index = i;
+                }
+            }
+            if (std::abs(plane_error(plane, points) - error) > 1e-9 * std::max(1.0, error)) {
+                framework.addFailure(testName, {3, static_cast<double>(count * 100 + p), error, plane_error(plane, points)});
+            }
+            double distance = 0.0;
+            int index = farthest_above(plane, points, distance);
+            if (index != expected_index || std::abs(distance - farthest) > 1e-9) {
+                framework.addFailure(testName, {4, static_cast<double>(count * 100 + p), static_cast<double>(expected_index), static_cast<double>(index)});
+            }
+        }
+    }
+
+    // 退化平面的距离全部为0，上方没有点
+    PointBatch points;
+    points.push(1.0, 2.0, 3.0);
+    points.push(-1.0, 0.5, 8.0);
+    double distance = 1.0;
+    if (plane_error(CuPlain(), points) != 0.0 || farthest_above(CuPlain(), points, distance) != -1 || distance != 0.0) {
+        framework.addFailure(testName, {5, 0, 0, 1});
+    }
+    points.erase(0);
+    if (points.size() != 1 || points.x[0] != -1.0 || points.z[0] != 8.0) {
+        framework.addFailure(testName, {6, 0, 1, static_cast<double>(points.size())});
+    }
+
+    std::vector<std::string> columnNames = {"test_case", "detail", "expected", "actual"};
+    framework.writeFailures(testName, "batch_failures.csv", columnNames);
+    framework.throwIfFailed(testName, "测试失败");
+
+    framework.info("batch_test: 通过所有测试用例");
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        // 设置工作目录
+        if (argc > 1) {
+            TestFramework::getInstance().setWorkingDirectory(argv[1]);
+        }
+        
+        TestFramework::getInstance().setLogFile("log/utils_test.log");
+        TestFramework::getInstance().info("=== 工具测试 ===");
+        
+        bool result = TestFramework::getInstance().runTests();
+        TestFramework::getInstance().info("=== 测试完成 ===");
+        
+        return result ? 0 : 1;
+    } catch (const std::exception& e) {
+        TestFramework::getInstance().error("测试执行出错: " + std::string(e.what()));
+        return 1;
+    }
+}